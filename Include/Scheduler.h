@@ -1,14 +1,28 @@
 #pragma once
 
 #define LOWEST_PRIORITY   0
-#define HIGHEST_PRIORITY  5
+#ifndef HIGHEST_PRIORITY
+#define HIGHEST_PRIORITY  5   /* at most 31, one ready bitmap bit per level */
+#endif
 
 #define MAXNAME           256
-#define MAXARG            256
+#define MAXARG            256   /* deprecated: arguments have no length limit */
 #define MAXPROC           50
+#define MAX_PROCESS_LIMIT 65535   /* most processes set_process_limit allows */
+
+/* Proportional share (stride) tickets */
+#define DEFAULT_TICKETS   100
+#define MAX_TICKETS       10000
 
 /* Kill signals */
 #define SIG_TERM			15
+#define MAX_SIGNAL			16   /* signals are 1 to MAX_SIGNAL */
+/* A signal stays pending until a k_wait, k_waitpid, k_join, block() or
+   k_wait_next_period reports it by returning -5, which clears all of the
+   process's pending signals.  signaled() reads them without clearing. */
+
+/* k_waitpid flags */
+#define WAIT_NOHANG			1
 
 int bootstrap(void* pArgs);
 
@@ -16,17 +30,23 @@ typedef int (*check_io_function) ();
 extern check_io_function check_io;
 
 /* Functions that will become system calls. */
+/* arg is shared between processes spawned with the same string; an entry
+   point must not write to it. */
 int  k_spawn(char* name, int(*entryPoint)(void*), void* arg, int stacksize, int priority);
+int  k_spawn_tickets(char* name, int(*entryPoint)(void*), void* arg, int stacksize, int priority, int tickets);
+int  k_spawn_rt(char* name, int(*entryPoint)(void*), void* arg, int stacksize, int runtime, int deadline, int period);
 
 #ifdef BUILD_DLL
 __declspec(dllexport) void SchedulerSetEntryPoint(int(*entryPoint)(void*));
 #endif
 
 int   k_wait(int* pChildExitCode);
+int   k_waitpid(int pid, int* pChildExitCode, int flags);
 int   k_join(int pid, int* pChildExitCode);
 int   k_kill(int pid, int signal);
 void  k_exit(int exitCode);
 int	  k_getpid(void);
+int   k_wait_next_period(void);
 
 /* Additional kernel-only functions. */
 int	  signaled(void);
@@ -35,6 +55,18 @@ int   block(int block_status);
 int   unblock(int pid);
 int   get_start_time(void);
 void  time_slice(void);
+int   set_time_slice(int priority, int milliseconds);
+int   set_mlfq(int enabled, int boostMilliseconds);
+int   set_cfs(int enabled);
+int   set_scheduler_policy(char* name);
+int   get_deadline_misses(int pid);
+int   set_tickless(int enabled);
+unsigned int read_interrupt_count(void);
+int   read_interrupt_rate(void);
+int   set_process_limit(int limit);
+int   read_process_capacity(void);
+int   set_stack_profiling(int level);
+void  display_stack_profile(void);
 void  dispatcher();
 int	  read_time(void);
 DWORD read_clock(void);
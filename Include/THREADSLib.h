@@ -1,9 +1,24 @@
 #pragma once
+#ifdef _WIN32
 #include <Windows.h>
+#else
+/* Linux-hosted runtime (THREADSLinux): the Windows types and CRT headers
+   that the scheduler and tests pick up through Windows.h. */
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdarg.h>
+#include <stdint.h>
+typedef uint32_t DWORD;
+typedef void*    LPVOID;
+#define TRUE     1
+#define FALSE    0
+#define ExitProcess(code) exit((int)(code))
+#endif
 #include <stdint.h>
 #include <stdbool.h>
 
-#ifdef THREADS_BUILD
+#if defined(THREADS_BUILD) && defined(_WIN32)
 #define LIB_SPEC __declspec(dllexport) 
 #else
 #define LIB_SPEC
@@ -42,6 +57,12 @@
 #define DISK_SEEK			  0x10
 #define TERMINAL_READ_CHAR    0x20
 #define TERMINAL_WRITE_CHAR   0x40
+#define CLOCK_SET_TIMER       0x80  /* control1 is the mode below, input_data a uint32_t* delay in us */
+
+/* CLOCK_SET_TIMER modes.  A one-shot delay of 0 disarms the clock; a
+   periodic timer with no delay uses the default tick. */
+#define CLOCK_PERIODIC        0
+#define CLOCK_ONE_SHOT        1
 
 /* Device types */
 typedef enum
@@ -85,6 +106,10 @@ typedef void (*system_call_handler_t)(system_call_arguments_t* pArgs);
 LIB_SPEC void*		 context_initialize(process_entrypoint_t entry_point, int stack_size, void* args);
 LIB_SPEC bool        context_switch(LPVOID next_context);
 LIB_SPEC void	     context_stop(LPVOID context);
+LIB_SPEC uint32_t    context_pool_trim(void);                  /* THREADSLinux: frees pooled stacks, returns bytes */
+LIB_SPEC uint32_t    context_stack_resident(LPVOID context);   /* THREADSLinux: committed stack bytes */
+LIB_SPEC void        context_stack_paint(bool enabled);        /* THREADSLinux: paint new stacks */
+LIB_SPEC uint32_t    context_stack_high_water(LPVOID context); /* THREADSLinux: painted stack bytes used */
 
 LIB_SPEC uint32_t    get_psr();
 LIB_SPEC void	     set_psr(uint32_t psr);
@@ -0,0 +1,90 @@
+#pragma once
+
+/* Intrusive doubly linked lists whose links are record numbers (0 for
+   none) rather than pointers, as the process and exit record tables use.
+
+	INDEX_DLIST(Name, Node, Index, FromIndex, next, prev)
+
+   defines the list operations for records of type Node linked through
+   their Index fields next and prev, with FromIndex(index) returning the
+   record for a number (NULL for 0).  A record can be on several lists at
+   once through different fields.  A list is a single Index holding its
+   first record; the first record's prev link is the last record, so
+   appending, popping the first and removing any record are all O(1).
+
+	Name##Append(Index* pHead, Index node)    - add node at the end
+	Name##Remove(Index* pHead, Index node)    - take node off the list
+	Name##Pop(Index* pHead)                   - remove and return the first, 0 if empty
+	Name##Take(Index* pHead)                  - empty the list and return its first
+
+   After Take the records still follow one another through next, ending in
+   0; the caller should clear the links as it goes.  Walk a list through
+   next from its head.
+
+   There is no singly linked form: every list here (ReadyQueue, JoinQueue
+   and ChildList in ProcessList.h, ZombieList in ZombieTable.c) removes
+   records from the middle. */
+
+#define INDEX_DLIST(Name, Node, Index, FromIndex, next, prev) \
+static inline void Name##Append(Index* pHead, Index node) \
+{ \
+	Node* pNode = FromIndex(node); \
+	Node* pFirst; \
+\
+	pNode->next = 0; \
+	if (*pHead == 0) \
+	{ \
+		pNode->prev = node; \
+		*pHead = node; \
+	} \
+	else \
+	{ \
+		pFirst = FromIndex(*pHead); \
+		pNode->prev = pFirst->prev; \
+		FromIndex(pFirst->prev)->next = node; \
+		pFirst->prev = node; \
+	} \
+} \
+\
+static inline void Name##Remove(Index* pHead, Index node) \
+{ \
+	Node* pNode = FromIndex(node); \
+	Node* pFirst = FromIndex(*pHead); \
+\
+	if (node == *pHead) \
+	{ \
+		*pHead = pNode->next; \
+	} \
+	else \
+	{ \
+		FromIndex(pNode->prev)->next = pNode->next; \
+	} \
+	if (pNode->next != 0) \
+	{ \
+		FromIndex(pNode->next)->prev = pNode->prev; \
+	} \
+	else if (pNode != pFirst) \
+	{ \
+		pFirst->prev = pNode->prev; \
+	} \
+	pNode->next = pNode->prev = 0; \
+} \
+\
+static inline Index Name##Pop(Index* pHead) \
+{ \
+	Index node = *pHead; \
+\
+	if (node != 0) \
+	{ \
+		Name##Remove(pHead, node); \
+	} \
+	return node; \
+} \
+\
+static inline Index Name##Take(Index* pHead) \
+{ \
+	Index node = *pHead; \
+\
+	*pHead = 0; \
+	return node; \
+}
@@ -0,0 +1,173 @@
+#include "THREADSLib.h"
+#include "Scheduler.h"
+#include "Processes.h"
+#include "ProcessHeap.h"
+#include "ProcessTable.h"
+
+static Process* HeapMerge(Process* pA, Process* pB);
+static Process* HeapMergePairs(Process* pFirst);
+
+/* ---------------------------------------------------------------
+    ProcessHeapInitialize
+
+    Purpose - Initialize an empty heap
+--------------------------------------------------------------- */
+void ProcessHeapInitialize(ProcessHeap* pHeap)
+{
+    pHeap->pRoot = NULL;
+    pHeap->count = 0;
+}
+
+/* ---------------------------------------------------------------
+    ProcessHeapInsert
+
+    Purpose - Adds a process keyed on its current sortKey
+    Parameters - ProcessHeap *pHeap, Process *pProc
+--------------------------------------------------------------- */
+void ProcessHeapInsert(ProcessHeap* pHeap, Process* pProc)
+{
+    pProc->pHeapChild = pProc->pHeapNext = pProc->pHeapPrev = 0;
+    pHeap->pRoot = HeapMerge(pHeap->pRoot, pProc);
+    pHeap->count++;
+}
+
+/* ---------------------------------------------------------------
+    ProcessHeapPop
+
+    Purpose - Removes the process with the smallest sortKey
+    Returns - the removed process, or NULL if the heap is empty
+--------------------------------------------------------------- */
+Process* ProcessHeapPop(ProcessHeap* pHeap)
+{
+    Process* pRoot = pHeap->pRoot;
+
+    if (pRoot != NULL)
+    {
+        pHeap->pRoot = HeapMergePairs(ProcessLink(pRoot, pHeapChild));
+        if (pHeap->pRoot != NULL)
+        {
+            pHeap->pRoot->pHeapPrev = 0;
+        }
+        pHeap->count--;
+        pRoot->pHeapChild = 0;
+    }
+    return pRoot;
+}
+
+/* ---------------------------------------------------------------
+    ProcessHeapRemove
+
+    Purpose - Removes a process from anywhere in the heap
+    Parameters - ProcessHeap *pHeap, Process *pProc - must be in pHeap
+--------------------------------------------------------------- */
+void ProcessHeapRemove(ProcessHeap* pHeap, Process* pProc)
+{
+    Process* pSubtree;
+    Process* pPrev = ProcessLink(pProc, pHeapPrev);
+    Process* pNext = ProcessLink(pProc, pHeapNext);
+
+    if (pProc == pHeap->pRoot)
+    {
+        ProcessHeapPop(pHeap);
+        return;
+    }
+
+    /* Unlink pProc's subtree from its parent or left sibling. */
+    if (pPrev->pHeapChild == pProc->index)
+    {
+        pPrev->pHeapChild = pProc->pHeapNext;
+    }
+    else
+    {
+        pPrev->pHeapNext = pProc->pHeapNext;
+    }
+    if (pNext != NULL)
+    {
+        pNext->pHeapPrev = pProc->pHeapPrev;
+    }
+
+    /* Its children become one heap that is merged back at the root. */
+    pSubtree = HeapMergePairs(ProcessLink(pProc, pHeapChild));
+    if (pSubtree != NULL)
+    {
+        pSubtree->pHeapPrev = 0;
+    }
+    pHeap->pRoot = HeapMerge(pHeap->pRoot, pSubtree);
+    pHeap->count--;
+
+    pProc->pHeapChild = pProc->pHeapNext = pProc->pHeapPrev = 0;
+}
+
+/* Links two heap roots; the larger key becomes the first child. */
+static Process* HeapMerge(Process* pA, Process* pB)
+{
+    Process* pTemp;
+
+    if (pA == NULL)
+    {
+        return pB;
+    }
+    if (pB == NULL)
+    {
+        return pA;
+    }
+    if (pB->sortKey < pA->sortKey)
+    {
+        pTemp = pA;
+        pA = pB;
+        pB = pTemp;
+    }
+
+    pB->pHeapPrev = pA->index;
+    pB->pHeapNext = pA->pHeapChild;
+    if (pA->pHeapChild != 0)
+    {
+        ProcessLink(pA, pHeapChild)->pHeapPrev = pB->index;
+    }
+    pA->pHeapChild = pB->index;
+    pA->pHeapNext = 0;
+    return pA;
+}
+
+/* Standard two-pass merge of a sibling list: pair left to right, then
+   fold the pairs right to left.  Iterative so deep heaps cannot overflow
+   a process stack. */
+static Process* HeapMergePairs(Process* pFirst)
+{
+    Process* pPairs = NULL;
+    Process* pA;
+    Process* pB;
+    Process* pNext;
+    Process* pResult;
+
+    /* First pass: merge pairs and push each result on a stack threaded
+       through pHeapNext. */
+    while (pFirst != NULL)
+    {
+        pA = pFirst;
+        pB = ProcessLink(pA, pHeapNext);
+        pNext = pB != NULL ? ProcessLink(pB, pHeapNext) : NULL;
+
+        pA->pHeapNext = pA->pHeapPrev = 0;
+        if (pB != NULL)
+        {
+            pB->pHeapNext = pB->pHeapPrev = 0;
+        }
+
+        pA = HeapMerge(pA, pB);
+        ProcessSetLink(pA, pHeapNext, pPairs);
+        pPairs = pA;
+        pFirst = pNext;
+    }
+
+    /* Second pass: fold the stack, which is already right to left. */
+    pResult = NULL;
+    while (pPairs != NULL)
+    {
+        pNext = ProcessLink(pPairs, pHeapNext);
+        pPairs->pHeapNext = 0;
+        pResult = HeapMerge(pResult, pPairs);
+        pPairs = pNext;
+    }
+    return pResult;
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+/* Pairing heap of processes ordered by Process.sortKey (smallest first).
+   Insert and peek are O(1), pop and remove are O(log n) amortized.  The
+   links live in the Process itself, so a process can be in at most one
+   heap at a time. */
+typedef struct
+{
+	Process* pRoot;
+	int count;
+} ProcessHeap;
+
+void     ProcessHeapInitialize(ProcessHeap* pHeap);
+void     ProcessHeapInsert(ProcessHeap* pHeap, Process* pProc);
+Process* ProcessHeapPop(ProcessHeap* pHeap);
+void     ProcessHeapRemove(ProcessHeap* pHeap, Process* pProc);
+
+#define ProcessHeapPeek(pHeap)  ((pHeap)->pRoot)
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "IndexList.h"
+
+/* The lists processes are kept on, instances of INDEX_DLIST (IndexList.h)
+   over the Process link fields.  Each takes and returns process indexes:
+   ChildListAppend(&pParent->pChildren, pChild->index).  Needs Processes.h
+   and ProcessTable.h first.
+
+	ReadyQueue - a ready list, through nextReadyProcess/prevReadyProcess
+	JoinQueue  - the processes in k_join on one target, in join order,
+	             through nextJoiner/prevJoiner
+	ChildList  - a parent's live children in spawn order, through
+	             nextSiblingProcess/prevSiblingProcess */
+INDEX_DLIST(ReadyQueue, Process, ProcessIndex, ProcessFromIndex, nextReadyProcess, prevReadyProcess)
+INDEX_DLIST(JoinQueue, Process, ProcessIndex, ProcessFromIndex, nextJoiner, prevJoiner)
+INDEX_DLIST(ChildList, Process, ProcessIndex, ProcessFromIndex, nextSiblingProcess, prevSiblingProcess)
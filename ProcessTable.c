@@ -0,0 +1,348 @@
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#ifdef _MSC_VER
+#include <malloc.h>
+#endif
+#include "THREADSLib.h"
+#include "Scheduler.h"
+#include "Processes.h"
+#include "ProcessTable.h"
+
+#define SUMMARY_WORDS       ((PROCESS_CHUNKS + 63) / 64)
+
+#if PROCESS_CHUNK_SIZE != 64
+#error the free slot masks assume 64 slots per chunk
+#endif
+#if MAX_PROCESS_LIMIT > PID_SLOT_MASK
+#error MAX_PROCESS_LIMIT must fit in the pid slot bits
+#endif
+_Static_assert(offsetof(Process, pHeapPrev) + sizeof(ProcessIndex) <= 64,
+    "the dispatch-hot Process fields must fit in one cache line");
+_Static_assert(sizeof(Process) <= 128, "Process should stay within two cache lines");
+
+Process* processChunks[PROCESS_CHUNKS];
+ProcessCold* processColdChunks[PROCESS_CHUNKS];
+static uint64_t chunkFree[PROCESS_CHUNKS];      /* bit n: slot n of the chunk is free and under the limit */
+static uint64_t chunkUsed[PROCESS_CHUNKS];      /* bit n: slot n of the chunk is in use */
+static uint64_t chunkSummary[SUMMARY_WORDS];    /* bit n: chunkFree[n] is non-zero */
+static unsigned short chunkEpoch[PROCESS_CHUNKS];   /* first generation of a re-allocated chunk */
+static int slotLimit;
+static int emptyChunks;                         /* allocated chunks with no live slots */
+static int allocatedChunks;
+
+static int AllocateChunk(int chunk);
+static void FreeChunk(int chunk);
+static void FreeChunkMemory(Process* pChunk, ProcessCold* pCold);
+static uint64_t LimitMask(int chunk, int limit);
+static void UpdateSummary(int chunk);
+static inline int LowestSetBit(uint64_t mask);
+
+/* ---------------------------------------------------------------
+    ProcessTableInitialize
+
+    Purpose - Sets up the empty table with a limit of MAXPROC
+--------------------------------------------------------------- */
+void ProcessTableInitialize(void)
+{
+    slotLimit = 0;
+    ProcessTableSetLimit(MAXPROC);
+}
+
+/* ---------------------------------------------------------------
+    ProcessTableAllocate
+
+    Purpose - Takes the lowest free slot, allocating its chunk if
+                needed.  Keeping the population in the lowest slots
+                lets the upper chunks empty out and be freed.
+    Returns - a zeroed Process with its pid set, or NULL if the
+                table is at its limit or out of memory
+--------------------------------------------------------------- */
+Process* ProcessTableAllocate(void)
+{
+    Process* pProc;
+    int word, chunk, bit;
+
+    for (word = 0; word < SUMMARY_WORDS && chunkSummary[word] == 0; ++word)
+        ;
+    if (word == SUMMARY_WORDS)
+    {
+        return NULL;
+    }
+    chunk = word * 64 + LowestSetBit(chunkSummary[word]);
+
+    if (processChunks[chunk] == NULL)
+    {
+        if (!AllocateChunk(chunk))
+        {
+            return NULL;
+        }
+    }
+    else if (chunkUsed[chunk] == 0 && chunk != 0)
+    {
+        emptyChunks--;
+    }
+
+    bit = LowestSetBit(chunkFree[chunk]);
+    chunkFree[chunk] &= ~(1ull << bit);
+    chunkUsed[chunk] |= 1ull << bit;
+    UpdateSummary(chunk);
+
+    pProc = &processChunks[chunk][bit];
+    pProc->pid = (pProc->generation << PID_SLOT_BITS) | (chunk * PROCESS_CHUNK_SIZE + bit + 1);
+    return pProc;
+}
+
+/* ---------------------------------------------------------------
+    ProcessTableRelease
+
+    Purpose - Clears a slot and makes it free again under a new
+                generation.  A chunk that empties is freed if another
+                empty chunk is already being kept; one is kept so a
+                population hovering at a chunk boundary does not
+                allocate and free on every spawn.  Chunk 0 is never
+                freed.
+    Parameters - a process returned by ProcessTableAllocate
+--------------------------------------------------------------- */
+void ProcessTableRelease(Process* pProc)
+{
+    int slot = (pProc->pid & PID_SLOT_MASK) - 1;
+    int chunk = slot / PROCESS_CHUNK_SIZE;
+    unsigned short generation = (pProc->generation + 1) & PID_GENERATION_MASK;
+    ProcessIndex index = pProc->index;
+
+    memset(pProc, 0, sizeof(Process));
+    pProc->generation = generation;
+    pProc->index = index;
+
+    chunkFree[chunk] |= 1ull << (slot % PROCESS_CHUNK_SIZE);
+    chunkUsed[chunk] &= ~(1ull << (slot % PROCESS_CHUNK_SIZE));
+    UpdateSummary(chunk);
+
+    if (chunkUsed[chunk] == 0 && chunk != 0)
+    {
+        if (emptyChunks > 0)
+        {
+            FreeChunk(chunk);
+        }
+        else
+        {
+            emptyChunks++;
+        }
+    }
+}
+
+/* ---------------------------------------------------------------
+    ProcessTableFind
+
+    Purpose - Resolves a pid without searching
+    Returns - the process, or NULL if pid is not a live process
+--------------------------------------------------------------- */
+Process* ProcessTableFind(int pid)
+{
+    int slot = (pid & PID_SLOT_MASK) - 1;
+    Process* pProc;
+
+    if (pid <= 0 || slot < 0 || slot >= slotLimit || processChunks[slot / PROCESS_CHUNK_SIZE] == NULL)
+    {
+        return NULL;
+    }
+
+    pProc = &processChunks[slot / PROCESS_CHUNK_SIZE][slot % PROCESS_CHUNK_SIZE];
+    if (pProc->pid != pid || pProc->status == STATUS_EMPTY)
+    {
+        return NULL;
+    }
+    return pProc;
+}
+
+/* ---------------------------------------------------------------
+    ProcessTableNext
+
+    Purpose - Walks the slots in use in slot order, skipping chunks
+                that are not allocated
+    Parameters - the previous process, or NULL to start
+    Returns - the next process, or NULL at the end of the table
+--------------------------------------------------------------- */
+Process* ProcessTableNext(Process* pPrevious)
+{
+    unsigned int start = pPrevious != NULL ? (pPrevious->pid & PID_SLOT_MASK) : 0;
+    unsigned int chunk = start / PROCESS_CHUNK_SIZE;
+    uint64_t used = chunkUsed[chunk] & (~0ull << (start % PROCESS_CHUNK_SIZE));
+
+    while (used == 0)
+    {
+        if (++chunk * PROCESS_CHUNK_SIZE >= (unsigned int)slotLimit)
+        {
+            return NULL;
+        }
+        used = chunkUsed[chunk];
+    }
+    return &processChunks[chunk][LowestSetBit(used)];
+}
+
+/* ---------------------------------------------------------------
+    ProcessTableSetLimit
+
+    Purpose - Changes how many slots may be in use.  Lowering the
+                limit frees the chunks above it, but fails if any of
+                the slots being removed is in use.
+    Parameters - the new limit, 1 to MAX_PROCESS_LIMIT
+    Returns - the previous limit, or -1
+--------------------------------------------------------------- */
+int ProcessTableSetLimit(int limit)
+{
+    int previous = slotLimit;
+    int lastChunk;
+    uint64_t removed;
+
+    if (limit < 1 || limit > MAX_PROCESS_LIMIT)
+    {
+        return -1;
+    }
+
+    lastChunk = ((limit > previous ? limit : previous) - 1) / PROCESS_CHUNK_SIZE;
+
+    /* Every slot that is being removed must be free. */
+    for (int i = limit / PROCESS_CHUNK_SIZE; limit < previous && i <= lastChunk; ++i)
+    {
+        removed = LimitMask(i, previous) & ~LimitMask(i, limit);
+        if ((chunkFree[i] & removed) != removed)
+        {
+            return -1;
+        }
+    }
+
+    for (int i = 0; i <= lastChunk; ++i)
+    {
+        chunkFree[i] = (chunkFree[i] & LimitMask(i, limit)) | (LimitMask(i, limit) & ~LimitMask(i, previous));
+        UpdateSummary(i);
+        /* Chunks now wholly above the limit hold nothing. */
+        if (processChunks[i] != NULL && LimitMask(i, limit) == 0)
+        {
+            emptyChunks--;
+            FreeChunk(i);
+        }
+    }
+    slotLimit = limit;
+
+    return previous;
+}
+
+/* ---------------------------------------------------------------
+    ProcessTableCapacity
+
+    Returns - the number of slots currently backed by memory
+--------------------------------------------------------------- */
+int ProcessTableCapacity(void)
+{
+    return allocatedChunks * PROCESS_CHUNK_SIZE;
+}
+
+/* Allocates a chunk of free slots that carry on from the generations the
+   chunk had when it was last freed.  The PCBs are cache line aligned; the
+   strings go in a separate block so walks over the PCBs never touch them. */
+static int AllocateChunk(int chunk)
+{
+    Process* pChunk;
+    ProcessCold* pCold = malloc(PROCESS_CHUNK_SIZE * sizeof(ProcessCold));
+
+#ifdef _MSC_VER
+    pChunk = _aligned_malloc(PROCESS_CHUNK_SIZE * sizeof(Process), 64);
+#else
+    pChunk = aligned_alloc(64, PROCESS_CHUNK_SIZE * sizeof(Process));
+#endif
+    if (pChunk == NULL || pCold == NULL)
+    {
+        FreeChunkMemory(pChunk, pCold);
+        return FALSE;
+    }
+
+    memset(pChunk, 0, PROCESS_CHUNK_SIZE * sizeof(Process));
+    for (int i = 0; i < PROCESS_CHUNK_SIZE; ++i)
+    {
+        pChunk[i].generation = chunkEpoch[chunk];
+        pChunk[i].index = (ProcessIndex)(chunk * PROCESS_CHUNK_SIZE + i + 1);
+    }
+    processChunks[chunk] = pChunk;
+    processColdChunks[chunk] = pCold;
+    allocatedChunks++;
+    return TRUE;
+}
+
+/* Frees an empty chunk, remembering where its generations got to so a
+   stale pid into it still fails after the chunk comes back. */
+static void FreeChunk(int chunk)
+{
+    unsigned short epoch = chunkEpoch[chunk];
+    int distance, furthest = 0;
+
+    for (int i = 0; i < PROCESS_CHUNK_SIZE; ++i)
+    {
+        distance = (processChunks[chunk][i].generation - epoch) & PID_GENERATION_MASK;
+        if (distance > furthest)
+        {
+            furthest = distance;
+        }
+    }
+    chunkEpoch[chunk] = (epoch + furthest) & PID_GENERATION_MASK;
+
+    FreeChunkMemory(processChunks[chunk], processColdChunks[chunk]);
+    processChunks[chunk] = NULL;
+    processColdChunks[chunk] = NULL;
+    allocatedChunks--;
+}
+
+static void FreeChunkMemory(Process* pChunk, ProcessCold* pCold)
+{
+#ifdef _MSC_VER
+    _aligned_free(pChunk);
+#else
+    free(pChunk);
+#endif
+    free(pCold);
+}
+
+/* The bits of a chunk that are below the slot limit. */
+static uint64_t LimitMask(int chunk, int limit)
+{
+    int count = limit - chunk * PROCESS_CHUNK_SIZE;
+
+    if (count <= 0)
+    {
+        return 0;
+    }
+    if (count >= PROCESS_CHUNK_SIZE)
+    {
+        return ~0ull;
+    }
+    return (1ull << count) - 1;
+}
+
+static void UpdateSummary(int chunk)
+{
+    if (chunkFree[chunk] != 0)
+    {
+        chunkSummary[chunk / 64] |= 1ull << (chunk % 64);
+    }
+    else
+    {
+        chunkSummary[chunk / 64] &= ~(1ull << (chunk % 64));
+    }
+}
+
+/* Index of the least significant set bit.  mask must be non-zero. */
+static inline int LowestSetBit(uint64_t mask)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    if (_BitScanForward(&index, (unsigned long)mask))
+    {
+        return (int)index;
+    }
+    _BitScanForward(&index, (unsigned long)(mask >> 32));
+    return (int)index + 32;
+#else
+    return __builtin_ctzll(mask);
+#endif
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+/* Process table.  Slots are handed out in chunks of PROCESS_CHUNK_SIZE
+   that are allocated on demand and never move, so a Process pointer stays
+   valid for the life of the process.  Up to the configured limit of slots
+   can be in use (MAXPROC by default, MAX_PROCESS_LIMIT at most).
+
+   A pid is (generation << PID_SLOT_BITS) | (slot + 1).  The generation of
+   a slot changes every time it is released, so a pid that outlives its
+   process no longer matches anything and pid 0 is never used. */
+#define PROCESS_CHUNK_SIZE      64
+#define PID_SLOT_BITS           16
+#define PID_SLOT_MASK           ((1 << PID_SLOT_BITS) - 1)
+#define PID_GENERATION_MASK     0x7fff
+#define PROCESS_CHUNKS          ((MAX_PROCESS_LIMIT + PROCESS_CHUNK_SIZE - 1) / PROCESS_CHUNK_SIZE)
+
+/* The chunk directory, for ProcessFromIndex(). */
+extern Process* processChunks[PROCESS_CHUNKS];
+extern ProcessCold* processColdChunks[PROCESS_CHUNKS];
+
+void     ProcessTableInitialize(void);
+Process* ProcessTableAllocate(void);
+void     ProcessTableRelease(Process* pProc);
+Process* ProcessTableFind(int pid);
+Process* ProcessTableNext(Process* pPrevious);
+int      ProcessTableSetLimit(int limit);
+int      ProcessTableCapacity(void);
+
+static inline Process* ProcessFromIndex(ProcessIndex index)
+{
+	unsigned int slot = (unsigned int)index - 1;
+
+	return index == 0 ? NULL : &processChunks[slot / PROCESS_CHUNK_SIZE][slot % PROCESS_CHUNK_SIZE];
+}
+
+static inline ProcessIndex ProcessIndexOf(Process* pProc)
+{
+	return pProc == NULL ? 0 : pProc->index;
+}
+
+/* The name, arguments and entry point of a process. */
+static inline ProcessCold* ProcessColdOf(Process* pProc)
+{
+	unsigned int slot = (unsigned int)pProc->index - 1;
+
+	return &processColdChunks[slot / PROCESS_CHUNK_SIZE][slot % PROCESS_CHUNK_SIZE];
+}
+
+/* Follow or set an index link: ProcessLink(pProc, pParent) is the parent
+   as a Process*, ProcessSetLink(pProc, pParent, pOther) points it at
+   pOther (or NULL). */
+#define ProcessLink(pProc, link)            ProcessFromIndex((pProc)->link)
+#define ProcessSetLink(pProc, link, pTo)    ((pProc)->link = ProcessIndexOf(pTo))
@@ -6,36 +6,96 @@
 #define STATUS_BLOCKED_WAIT		3
 #define STATUS_BLOCKED_JOIN		4
 #define STATUS_EXITED			5
+#define STATUS_BLOCKED_PERIOD	6
 
 
-typedef struct _process
-{
-	struct _process*        nextReadyProcess;
-	struct _process*		nextSiblingProcess;
+/* PCBs start on a cache line boundary so the fields the dispatcher and
+   the run queues use every time fit in a single line. */
+#ifdef _MSC_VER
+#define CACHE_ALIGNED __declspec(align(64))
+#else
+#define CACHE_ALIGNED __attribute__((aligned(64)))
+#endif
 
-	struct _process*		pParent;
-	struct _process*        pChildren;
-	struct _process*        pActiveChildren;
-	struct _process*        pExitingChildren;
+/* Per-process data that is only read at launch, for display and for
+   statistics.  It lives outside the PCB (see ProcessTable.c); the strings
+   are in the string arena. */
+typedef struct _process_cold
+{
+	const char*    name;              /* Process name */
+	const char*    startArgs;         /* Process arguments */
+	int (*entryPoint) (void*);        /* The entry point that is called from launch */
+	int            stackSize;         /* k_spawn stack size */
+	int            deadlineMisses;    /* real-time jobs finished after their deadline */
+	int            rtRuntime;         /* real-time CPU budget per period, microseconds */
+	int            rtDeadline;        /* real-time deadline relative to the release */
+} ProcessCold;
 
-	struct _process*        pJoiners;
+/* Links between PCBs are process table indexes (slot + 1, 0 for none)
+   rather than pointers.  Read and write them with ProcessLink() and
+   ProcessSetLink() from ProcessTable.h. */
+typedef unsigned short ProcessIndex;
 
-	char           name[MAXNAME];     /* Process name */
-	char           startArgs[MAXARG]; /* Process arguments */
+typedef struct CACHE_ALIGNED _process
+{
+	/* Dispatch-hot: read or written on every enqueue, pick and context
+	   switch.  These must stay within the first 64 bytes. */
 	void*		   context;           /* Process's current context */
-	short          pid;               /* Process id (pid) */
-	int            priority;
-	int (*entryPoint) (void*);        /* The entry point that is called from launch */
-	//char*	       stack;
-	//unsigned int   stacksize;
+	uint64_t       sortKey;           /* ProcessHeap ordering key */
 	int            status;            /* READY, QUIT, BLOCKED, etc. */
+	int            priority;          /* current (effective) priority */
+	int            rtPeriod;          /* real-time period in microseconds, 0 if not real-time */
+	DWORD          sliceStart;        /* read_clock() when last dispatched */
+	ProcessIndex   index;             /* this process's own index, fixed per slot */
+	ProcessIndex   nextReadyProcess;  /* ready list (ReadyQueue) */
+	ProcessIndex   prevReadyProcess;
+	ProcessIndex   pHeapChild;
+	ProcessIndex   pHeapNext;
+	ProcessIndex   pHeapPrev;         /* left sibling, or parent if first child */
+	unsigned short generation;        /* bumped each time the slot is released */
+	unsigned short tickets;           /* stride scheduling share of the CPU */
+	int            pid;               /* Process id (pid), see ProcessTable.h */
+	int            inheritedPriority; /* highest priority of the processes waiting on this one */
+	uint64_t       cpuTime;           /* CPU time used in microseconds */
+
+	/* Fair and stride scheduling: weighted virtual runtime and pass. */
+	uint64_t       vruntime;          /* weighted CPU time in microseconds */
+	uint64_t       pass;
+
+	int            basePriority;      /* priority given to k_spawn */
+
+	/* Family: live children are a ChildList through the sibling links,
+	   headed by pChildren. */
+	ProcessIndex   nextSiblingProcess;
+	ProcessIndex   prevSiblingProcess;
+	ProcessIndex   pParent;
+	ProcessIndex   pChildren;
+	unsigned int   zombies;           /* queue of exited children not yet reaped, see ZombieTable.h */
+	unsigned short childPriority;     /* what the children inherit from k_waitpid, LOWEST_PRIORITY if nothing */
+	ProcessIndex   waitChild;         /* the one child k_waitpid(pid) raises, 0 for all of them */
+
+	/* k_join: the processes joined with this one, in a JoinQueue through
+	   their joiner links, and the process this one is joined with. */
+	ProcessIndex   joiners;
+	ProcessIndex   pJoinTarget;
+	ProcessIndex   nextJoiner;
+	ProcessIndex   prevJoiner;
+	int            joinExitCode;
+
+	/* Signals sent by k_kill, bit signal - 1.  Acted on where a blocking
+	   call returns from the dispatcher. */
+	unsigned short pendingSignals;
 
-	int			   exitCode;
+	/* Earliest deadline first class.  Times are in microseconds; the
+	   budget and deadline of each job are in ProcessCold. */
+	int            rtBudget;          /* CPU the current job has left */
+	DWORD          rtAbsDeadline;     /* deadline of the current job */
+	DWORD          rtNextRelease;     /* start of the next period */
 } Process;
 
 typedef struct
 {
-	Process* pHead;
-	Process* pTail;
+	ProcessIndex head;          /* first process, a ReadyQueue */
 	int count;
+	unsigned int priorityBit;   /* ready bitmap bit for this list, 0 if not a ready list */
 } List;
\ No newline at end of file
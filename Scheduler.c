@@ -2,39 +2,65 @@
 #define _CRT_SECURE_NO_WARNINGS
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
 #include "THREADSLib.h"
 #include "Scheduler.h"
 #include "Processes.h"
+#include "SchedulerPolicy.h"
+#include "ProcessTable.h"
+#include "ProcessList.h"
+#include "StringArena.h"
+#include "StackProfile.h"
+#include "ZombieTable.h"
 
-Process processTable[MAX_PROCESSES];
 Process *runningProcess = NULL;
 
-//Process* readyList[HIGHEST_PRIORITY + 1]; // One list per priority
-List readyList[HIGHEST_PRIORITY + 1]; // One list per priority
-List priority1;
-List priority2;
-List priority3;
-List priority4;
-List priority5;
+/* The active scheduling policy; see SchedulerPolicy.h. */
+const SchedulerPolicy* schedulerPolicy = &PriorityPolicy;
+static const SchedulerPolicy* policies[] = { &PriorityPolicy, &MlfqPolicy, &CfsPolicy, &StridePolicy };
+
+/* Time slice (quantum) per priority level in milliseconds. */
+#define DEFAULT_TIME_SLICE_MS   80
+int timeSlice[HIGHEST_PRIORITY + 1];
+
+/* Tickless mode.  Instead of the periodic tick the clock is programmed as a
+   one-shot for the next event: the end of the running slice while another
+   process is ready, or the next real-time release.  With nothing else
+   ready there is no clock interrupt at all. */
+static int ticklessEnabled;
+static int timerArmed;              /* a one-shot is programmed for timerExpiry */
+static DWORD timerExpiry;
+static int readyCount;              /* ready processes, not counting the watchdog */
+static unsigned int timerInterrupts;
+static void ProgramTimer(void);
 
-int nextPid = 1;
 int debugFlag = 0;
 
 static int watchdog(char*);
 static inline void disableInterrupts();
+static inline void enableInterrupts();
 void dispatcher();
 static int launch(void *);
 static void check_deadlock();
 static void DebugConsole(char* format, ...);
 
-static int GetNextPid();
+static int SpawnProcess(char* name, int (*entryPoint)(void *), void* arg, int stacksize, int priority,
+                        int tickets, int rtRuntime, int rtDeadline, int rtPeriod);
 Process* GetNextReadyProc();
-static int processCount;
+static void ReleaseProcessSlot(Process* pProc);
+static void ReleaseProcessStrings(Process* pProc);
 void timer_interrupt_handler(char deviceId[32], uint8_t command, uint32_t status);
 
-static void ListInitialize(List* pList);
-static void ListAddNode(List* pList, Process* pProcToAdd);
-//void AddToReadyList(Process* pProcess);
+void AddToReadyList(Process* pProcess);
+static void ChangePriority(Process* pProc, int priority);
+static void UpdateInheritance(Process* pProc);
+static void InheritFromParent(Process* pParent);
+static void SetChildPriority(Process* pParent, int priority, ProcessIndex child);
+static void OrphanChildren(Process* pParent);
+static void AddChild(Process* pParent, Process* pChild);
+static void RemoveChild(Process* pParent, Process* pChild);
+static int TakeSignals(Process* pProc);
 
 int booting = 1;
 
@@ -69,27 +95,63 @@ check_io_function check_io;
 int bootstrap(void *pArgs)
 {
     int result; /* value returned by call to spawn() */
+    interrupt_handler_t* intVector;
+    char* policyName;
 
     /* set this to the scheduler version of this function.*/
     check_io = check_io_scheduler;
 
     /* Initialize the process table. */
+    ProcessTableInitialize();
 
     /* Initialize the Ready list, etc. */
-    ListInitialize(&priority1);
-    ListInitialize(&priority2);
-    ListInitialize(&priority3);
-    ListInitialize(&priority4);
-    ListInitialize(&priority5);
-    readyList[1] = priority1;
-    readyList[2] = priority2;
-    readyList[3] = priority3;
-    readyList[4] = priority4;
-    readyList[5] = priority5;
+    for (int i = LOWEST_PRIORITY; i <= HIGHEST_PRIORITY; ++i)
+    {
+        ListInitialize(&readyList[i]);
+        readyList[i].priorityBit = 1u << i;
+        timeSlice[i] = DEFAULT_TIME_SLICE_MS;
+    }
+    readyBitmap = 0;
+    EdfInitialize();
+
+    /* SCHEDULER_POLICY names the scheduling policy (priority, mlfq, cfs,
+       stride).  SCHEDULER_MLFQ=1 and SCHEDULER_CFS=1 are kept as
+       shorthands, and SCHEDULER_MLFQ_BOOST_MS sets the feedback boost
+       interval. */
+    policyName = getenv("SCHEDULER_POLICY");
+    if (policyName == NULL && getenv("SCHEDULER_CFS") != NULL && atoi(getenv("SCHEDULER_CFS")) != 0)
+    {
+        policyName = "cfs";
+    }
+    if (policyName == NULL && getenv("SCHEDULER_MLFQ") != NULL && atoi(getenv("SCHEDULER_MLFQ")) != 0)
+    {
+        policyName = "mlfq";
+    }
+    if (policyName != NULL && set_scheduler_policy(policyName) < 0)
+    {
+        console_output(debugFlag, "Scheduler(): unknown scheduling policy %s, stopping...\n", policyName);
+        stop(1);
+    }
+    if (schedulerPolicy == &MlfqPolicy && getenv("SCHEDULER_MLFQ_BOOST_MS") != NULL)
+    {
+        set_mlfq(TRUE, atoi(getenv("SCHEDULER_MLFQ_BOOST_MS")));
+    }
+    if (getenv("SCHEDULER_TICKLESS") != NULL && atoi(getenv("SCHEDULER_TICKLESS")) != 0 &&
+        set_tickless(TRUE) < 0)
+    {
+        console_output(debugFlag, "Scheduler(): clock has no one-shot mode, staying periodic\n");
+    }
+
+    /* SCHEDULER_STACK_PROFILE=1 summarises stack use per entry point when
+       the system stops, 2 also reports each process as it exits. */
+    if (getenv("SCHEDULER_STACK_PROFILE") != NULL)
+    {
+        set_stack_profiling(atoi(getenv("SCHEDULER_STACK_PROFILE")));
+    }
 
     /* Initialize the clock interrupt handler */
-    //intVector = get_interrupt_handlers();
-    //intVector[THREADS_TIMER_INTERRUPT] = timer_interrupt_handler;
+    intVector = get_interrupt_handlers();
+    intVector[THREADS_TIMER_INTERRUPT] = timer_interrupt_handler;
 
     /* startup a watchdog process */
     result = k_spawn("watchdog", watchdog, NULL, THREADS_MIN_STACK_SIZE, LOWEST_PRIORITY);
@@ -127,18 +189,86 @@ int bootstrap(void *pArgs)
              information of the process.  Updates information in the
              parent process to reflect this child process creation.
 
-   Parameters - the process's entry point function, the stack size, and
-                the process's priority.
+   Parameters - the process's name, entry point function and argument,
+                the stack size, and the process's priority.  The argument
+                string is interned (StringArena.c) and shared with every
+                process spawned with the same text, so the entry point
+                receives it as char* but must not write to it.
 
-   Returns - The Process ID (pid) of the new child process 
+   Returns - The Process ID (pid) of the new child process, -1 for a
+             bad argument or a full table, or -2 if the stack size is
+             below THREADS_MIN_STACK_SIZE.
              The function must return if the process cannot be created.
 
 ************************************************************************ */
 int k_spawn(char* name, int (*entryPoint)(void *), void* arg, int stacksize, int priority)
 {
-    int proc_slot;
-    int myPid;
+    return k_spawn_tickets(name, entryPoint, arg, stacksize, priority, DEFAULT_TICKETS);
+}
+
+/*************************************************************************
+   k_spawn_tickets()
+
+   Purpose - k_spawn with a stride scheduling ticket count.  The tickets
+             only matter under the stride policy.
+
+   Parameters - as k_spawn, plus tickets (1 to MAX_TICKETS)
+
+   Returns - The Process ID (pid) of the new child process, or -1
+
+************************************************************************ */
+int k_spawn_tickets(char* name, int (*entryPoint)(void *), void* arg, int stacksize, int priority, int tickets)
+{
+    return SpawnProcess(name, entryPoint, arg, stacksize, priority, tickets, 0, 0, 0);
+}
+
+/*************************************************************************
+   k_spawn_rt()
+
+   Purpose - spawns a process in the earliest deadline first real-time
+             class.  It runs ahead of every other process while it has a
+             job released, and calls k_wait_next_period() at the end of
+             each job.
+
+   Parameters - name, entry point, arg and stack size as k_spawn, then
+                the CPU budget per period, the deadline relative to the
+                start of each period, and the period, all in milliseconds
+                (0 < runtime <= deadline <= period).
+
+   Returns - The pid of the new process, -1 for a bad argument, or -2 if
+             admitting it would take real-time utilisation above 1.0
+
+************************************************************************ */
+int k_spawn_rt(char* name, int (*entryPoint)(void *), void* arg, int stacksize,
+               int runtime, int deadline, int period)
+{
+    if (runtime <= 0 || runtime > deadline || deadline > period || period > INT_MAX / 1000)
+    {
+        console_output(debugFlag, "spawn_rt(): Invalid timing %d/%d/%d.\n", runtime, deadline, period);
+        return -1;
+    }
+
+    return SpawnProcess(name, entryPoint, arg, stacksize, HIGHEST_PRIORITY, DEFAULT_TICKETS,
+                        runtime * 1000, deadline * 1000, period * 1000);
+}
+
+/*************************************************************************
+   SpawnProcess()
+
+   Purpose - Common body of the k_spawn variants.
+
+   Parameters - as k_spawn, plus the ticket count and, for a real-time
+                process, its runtime, deadline and period in microseconds
+                (rtPeriod is 0 otherwise)
+
+   Returns - the pid, or a negative k_spawn error code
+
+************************************************************************ */
+static int SpawnProcess(char* name, int (*entryPoint)(void *), void* arg, int stacksize, int priority,
+                        int tickets, int rtRuntime, int rtDeadline, int rtPeriod)
+{
     struct _process* pNewProc;
+    ProcessCold* pCold;
 
     DebugConsole("spawn(): creating process %s\n", name);
 
@@ -148,6 +278,7 @@ int k_spawn(char* name, int (*entryPoint)(void *), void* arg, int stacksize, int
     if (name == NULL)
     {
         console_output(debugFlag, "spawn(): Name value is NULL.\n");
+        enableInterrupts();
         return -1;
     }
     if (strlen(name) >= (MAXNAME - 1))
@@ -156,49 +287,105 @@ int k_spawn(char* name, int (*entryPoint)(void *), void* arg, int stacksize, int
         stop( 1);
     }
 
+    /* Only the watchdog runs at LOWEST_PRIORITY. */
+    if (priority > HIGHEST_PRIORITY || priority < LOWEST_PRIORITY ||
+        (priority == LOWEST_PRIORITY && !booting))
+    {
+        console_output(debugFlag, "spawn(): Invalid priority %d.\n", priority);
+        enableInterrupts();
+        return -1;
+    }
+    if (tickets < 1 || tickets > MAX_TICKETS)
+    {
+        console_output(debugFlag, "spawn(): Invalid ticket count %d.\n", tickets);
+        enableInterrupts();
+        return -1;
+    }
+    if (stacksize < THREADS_MIN_STACK_SIZE)
+    {
+        console_output(debugFlag, "spawn(): Stack size %d is below the minimum.\n", stacksize);
+        enableInterrupts();
+        return -2;
+    }
 
     /* Find an empty slot in the process table */
-    int i;
-    for (i = nextPid; processTable[i].status != 0; ++i);
-
-    myPid = GetNextPid();
-    //myPid = 2; // Changing this to 3 causes access violation inside dispatcher
-    
-    proc_slot = myPid % MAX_PROCESSES;
-    //proc_slot = 1;  // just use 1 for now!
-    pNewProc = &processTable[proc_slot];
-
-    /* Setup the entry in the process table. */
-    strcpy(pNewProc->name, name);
+    pNewProc = ProcessTableAllocate();
+    if (pNewProc == NULL)
+    {
+        console_output(debugFlag, "spawn(): Process table is full.\n");
+        enableInterrupts();
+        return -1;
+    }
+    /* Setup the entry in the process table.  The name and arguments are
+       interned, so only a string the arena does not hold yet is copied. */
+    pCold = ProcessColdOf(pNewProc);
+    pCold->name = StringArenaIntern(name);
+    pCold->startArgs = StringArenaIntern(arg != NULL ? (char*)arg : "");
+    if (pCold->name == NULL || pCold->startArgs == NULL)
+    {
+        console_output(debugFlag, "spawn(): Out of memory for the process strings.\n");
+        ReleaseProcessStrings(pNewProc);
+        ProcessTableRelease(pNewProc);
+        enableInterrupts();
+        return -1;
+    }
 
-    if (arg != NULL)
+    /* Initialize context for this process, but use launch function pointer for
+     * the initial value of the process's program counter (PC)
+    */
+    pNewProc->context = context_initialize(launch, stacksize, arg);
+    if (pNewProc->context == NULL)
+    {
+        console_output(debugFlag, "spawn(): Out of memory for the process stack.\n");
+        ReleaseProcessStrings(pNewProc);
+        ProcessTableRelease(pNewProc);
+        enableInterrupts();
+        return -1;
+    }
+    if (rtPeriod != 0 && !EdfReserve(rtRuntime, rtDeadline, rtPeriod))
     {
-        strcpy(pNewProc->startArgs, (char*)arg);
+        console_output(debugFlag, "spawn(): Real-time utilisation would exceed 1.0.\n");
+        ReleaseProcessSlot(pNewProc);
+        enableInterrupts();
+        return -2;
     }
 
-    pNewProc->pid = myPid;
     pNewProc->priority = priority;
-    pNewProc->pParent = runningProcess;
+    pNewProc->basePriority = priority;
+    pNewProc->inheritedPriority = LOWEST_PRIORITY;
+    pNewProc->childPriority = LOWEST_PRIORITY;
+    pNewProc->waitChild = 0;
+    pNewProc->joiners = 0;
+    pNewProc->pendingSignals = 0;
+    pNewProc->pJoinTarget = 0;
+    pNewProc->cpuTime = 0;
+    pNewProc->vruntime = 0;
+    pNewProc->tickets = tickets;
+    pNewProc->pass = 0;
+    pNewProc->rtPeriod = 0;
+    if (rtPeriod != 0)
+    {
+        EdfAttach(pNewProc, rtRuntime, rtDeadline, rtPeriod, read_clock());
+    }
+    ProcessSetLink(pNewProc, pParent, runningProcess);
     pNewProc->status = STATUS_READY;
-    pNewProc->entryPoint = entryPoint;
+    pCold->entryPoint = entryPoint;
+    pCold->stackSize = stacksize;
 
     /* If there is a parent process,add this to the list of children. */
     if (runningProcess != NULL)
     {
+        AddChild(runningProcess, pNewProc);
     }
 
     /* Add the process to the ready list. */
-    //AddToReadyList(pNewProc);
-    ListAddNode(&readyList[priority], pNewProc);
-
-    /* Initialize context for this process, but use launch function pointer for
-     * the initial value of the process's program counter (PC)
-    */
-    pNewProc->context = context_initialize(launch, stacksize, arg);
+    AddToReadyList(pNewProc);
 
     if (!booting)
         dispatcher();
 
+    enableInterrupts();
+
     return pNewProc->pid;
 
 
@@ -217,13 +404,12 @@ int k_spawn(char* name, int (*entryPoint)(void *), void* arg, int stacksize, int
 static int launch(void *args)
 {
     int resultCode;
-    DebugConsole("launch(): started: %s\n", runningProcess->name);
-
-    /* TODO: Enable interrupts */
+    DebugConsole("launch(): started: %s\n", ProcessColdOf(runningProcess)->name);
 
+    enableInterrupts();
 
     /* Call the function passed to spawn and capture its return value */
-    resultCode = runningProcess->entryPoint(runningProcess->startArgs);
+    resultCode = ProcessColdOf(runningProcess)->entryPoint((char*)ProcessColdOf(runningProcess)->startArgs);
 
     DebugConsole("Process %d returned to launch\n", runningProcess->pid);
 
@@ -237,7 +423,8 @@ static int launch(void *args)
    Name - k_wait
 
    Purpose - Wait for a child process to quit.  Return right away if
-             a child has already quit.
+             a child has already quit.  Children are reaped in the
+             order they quit.
 
    Parameters - Output parameter for the child's exit code. 
 
@@ -248,38 +435,118 @@ static int launch(void *args)
 ************************************************************************ */
 int k_wait(int* code)
 {
-    int result = 0;
-    Process* pExitingChild;
+    return k_waitpid(-1, code, 0);
+}
+
+/**************************************************************************
+   Name - k_waitpid
 
-    // Change my state to BLOCKED
-    runningProcess->status = STATUS_BLOCKED_WAIT;
+   Purpose - k_wait for one particular child, or for any child with pid
+             -1.  With WAIT_NOHANG it never blocks: if the child has not
+             quit it returns 0 at once.  Finding an exited child is O(1)
+             either way (the parent's exit queue, or the exit record
+             found by pid).
 
-    dispatcher();
+             While blocked the caller lends its priority to the child it
+             waits for, or to all of its children with pid -1.  The loan
+             for one child ends when that child exits.  The loan to all
+             children outlives the wait so that reaping them one by one
+             does not walk the rest each time: they keep the priority
+             until the caller gives up the CPU other than to wait again,
+             or at the latest until the next clock tick while it runs.
 
-    // Interrupts are enabled here
+   Parameters - the pid of a child or -1, output parameter for the
+                child's exit code, 0 or WAIT_NOHANG
 
-    // Get the exit code of the child
-    // TODO: Pop first child off of exiting child list
-    pExitingChild = runningProcess->pExitingChildren;
+   Returns - the pid of the quitting child, or
+        0 with WAIT_NOHANG if the child has not quit yet
+        -1 for a pid that is neither -1 nor positive
+        -4 if the process has no children, or pid is not its child
+        -5 if the process was signaled before a child quit
+
+************************************************************************ */
+int k_waitpid(int pid, int* code, int flags)
+{
+    unsigned int zombie;
+    Zombie* pZombie;
+    Process* pChild;
 
-    if (pExitingChild != NULL)
+    if (pid == 0 || pid < -1)
     {
-        *code = pExitingChild->exitCode;
-        result = pExitingChild->pid;
+        return -1;
     }
 
-    // Clean up after the child
-    memset(pExitingChild, 0, sizeof(Process));
+    while (1)
+    {
+        disableInterrupts();
 
-    return result;
+        if (pid == -1)
+        {
+            zombie = runningProcess->zombies;
+        }
+        else
+        {
+            zombie = ZombieFind(pid);
+            if (zombie != 0 && ZombieFromNumber(zombie)->parentPid != runningProcess->pid)
+            {
+                zombie = 0;
+            }
+        }
+        if (zombie != 0)
+        {
+            break;
+        }
 
-} 
+        /* Nothing has quit: is there anything left to wait for? */
+        pChild = pid == -1 ? NULL : ProcessTableFind(pid);
+        if (pid == -1 ? runningProcess->pChildren == 0 :
+            (pChild == NULL || pChild->pParent != runningProcess->index))
+        {
+            enableInterrupts();
+            return -4;
+        }
+        if (flags & WAIT_NOHANG)
+        {
+            enableInterrupts();
+            return 0;
+        }
+        if (TakeSignals(runningProcess))
+        {
+            enableInterrupts();
+            return -5;
+        }
+
+        /* Any child quitting wakes us, so check again after each one. */
+        runningProcess->status = STATUS_BLOCKED_WAIT;
+
+        /* The child, or with pid -1 all the children, now run with at
+           least this process's priority.  Coming back for the next
+           child, they usually still do. */
+        SetChildPriority(runningProcess, runningProcess->priority,
+            pChild != NULL ? pChild->index : 0);
+
+        dispatcher();
+    }
+
+    pZombie = ZombieFromNumber(zombie);
+    ZombieQueueRemove(&runningProcess->zombies, zombie);
+    *code = pZombie->exitCode;
+    pid = pZombie->pid;
+    ZombieRelease(zombie);
+
+    enableInterrupts();
+
+    return pid;
+}
 
 /**************************************************************************
    Name - k_exit
 
    Purpose - Exits a process and coordinates with the parent for cleanup 
-             and return of the exit code.
+             and return of the exit code.  The process leaves the table
+             at once; a parent that has not reaped it yet keeps only an
+             exit record (ZombieTable.h).  Its children become orphans
+             and its own unreaped children are discarded.
 
    Parameters - the code to return to the grieving parent
 
@@ -289,33 +556,75 @@ int k_wait(int* code)
 void k_exit(int code)
 {
     Process* pParent;
+    Process* pJoiner;
+    unsigned int zombie;
+
+    disableInterrupts();
+
+    StackProfileRecord(runningProcess);
+    pParent = ProcessLink(runningProcess, pParent);
+
+    if (runningProcess->rtPeriod != 0)
+    {
+        EdfDetach(runningProcess);
+    }
+
+    /* Hand the exit code to every process joined with this one and make
+       them all ready in the order they joined.  The one dispatcher call
+       below decides who runs, however many were woken. */
+    pJoiner = ProcessFromIndex(JoinQueueTake(&runningProcess->joiners));
+    while (pJoiner != NULL)
+    {
+        Process* pNext = ProcessLink(pJoiner, nextJoiner);
 
-    // TODO: Disable interrupts
+        pJoiner->nextJoiner = pJoiner->prevJoiner = 0;
+        pJoiner->pJoinTarget = 0;
+        pJoiner->joinExitCode = code;
+        AddToReadyList(pJoiner);
+        pJoiner = pNext;
+    }
 
-    pParent = runningProcess->pParent;
+    SetChildPriority(runningProcess, LOWEST_PRIORITY, 0);
+    OrphanChildren(runningProcess);
+    while ((zombie = ZombieQueuePop(&runningProcess->zombies)) != 0)
+    {
+        ZombieRelease(zombie);
+    }
 
-    // Wake up the parent process only if they're in k_wait
+    /* Leave an exit record on the parent's list. */
     if (pParent != NULL)
     {
-        if (pParent->status == STATUS_BLOCKED_WAIT)
+        RemoveChild(pParent, runningProcess);
+        if (pParent->waitChild == runningProcess->index)
         {
-            //AddToReadyList(pParent);
-            ListAddNode(&readyList[runningProcess->priority], pParent);
+            /* The parent's k_waitpid only raised this child. */
+            pParent->childPriority = LOWEST_PRIORITY;
+            pParent->waitChild = 0;
+        }
+        zombie = ZombieCreate(runningProcess->pid, pParent->pid, code);
+        if (zombie == 0)
+        {
+            console_output(debugFlag, "k_exit(): Out of memory for the exit record.\n");
+        }
+        else
+        {
+            ZombieQueuePush(&pParent->zombies, zombie);
         }
-
-        // Put parent process on the ready list
-        runningProcess->exitCode = code;
-        runningProcess->status = STATUS_EXITED;
-
-        // Add myself to the quit children list of the parent
-        // TODO: Make this a list of children
-        pParent->pExitingChildren = runningProcess;
     }
-    else
+
+    /* The slot, context and strings go now.  The runtime frees the stack
+       once we have switched off it; nothing may touch the PCB after this,
+       as its chunk can be freed with it. */
+    ReleaseProcessSlot(runningProcess);
+    runningProcess = NULL;
+
+    /* Wake up the parent process only if they're in k_wait.  The
+       siblings keep the parent's priority until it gives up the CPU
+       other than to wait again (see dispatcher), so reaping each child
+       in turn does not walk the others. */
+    if (pParent != NULL && pParent->status == STATUS_BLOCKED_WAIT)
     {
-        // Reset the main entry in the process table
-        // ClearPCB();
-        memset(runningProcess, 0, sizeof(Process));
+        AddToReadyList(pParent);
     }
 
     dispatcher();
@@ -325,266 +634,711 @@ void k_exit(int code)
 /**************************************************************************
    Name - k_kill
 
-   Purpose - Signals a process with the specified signal
+   Purpose - Signals a process.  The signal stays pending until a call
+             reports it by returning -5, which clears every pending
+             signal.  A process blocked in k_wait, k_join or block() is
+             taken off what it waits on and made ready, and the call
+             returns -5; one that is not blocked gets -5 from its next
+             k_wait, k_join or block().  A real-time process waiting
+             for its next period is not woken early, as running outside
+             its reserved share could make other real-time processes
+             miss their deadlines; k_wait_next_period returns -5 at the
+             release instead, at most one period later.  signaled()
+             tells a running process it has been signaled without
+             clearing the signal.
+
+   Parameters - pid of the process, signal 1 to MAX_SIGNAL
+
+   Returns - 0, or
+        -1 if no such process exists
+        -2 if the signal is out of range
 
-   Parameters - Signal to send
-
-   Returns -
 *************************************************************************/
 int k_kill(int pid, int signal)
 {
-    int result = 0;
+    Process* pProc;
+    Process* pTarget;
+
+    if (signal < 1 || signal > MAX_SIGNAL)
+    {
+        return -2;
+    }
+
+    disableInterrupts();
+
+    pProc = ProcessTableFind(pid);
+    if (pProc == NULL)
+    {
+        enableInterrupts();
+        return -1;
+    }
+    pProc->pendingSignals |= 1u << (signal - 1);
+
+    switch (pProc->status)
+    {
+    case STATUS_READY:
+    case STATUS_RUNNING:
+    case STATUS_BLOCKED_PERIOD:
+        /* Running, or due to run at its next release, when
+           k_wait_next_period reports the signal. */
+        enableInterrupts();
+        return 0;
+
+    case STATUS_BLOCKED_JOIN:
+        pTarget = ProcessLink(pProc, pJoinTarget);
+        JoinQueueRemove(&pTarget->joiners, pProc->index);
+        AddToReadyList(pProc);
+        UpdateInheritance(pTarget);
+        break;
+
+    case STATUS_BLOCKED_WAIT:
+        /* The children lose its priority as in k_exit. */
+        SetChildPriority(pProc, LOWEST_PRIORITY, 0);
+        AddToReadyList(pProc);
+        break;
+
+    default:
+        /* block() */
+        AddToReadyList(pProc);
+        break;
+    }
+
+    /* The woken process may outrank the caller. */
+    dispatcher();
+
+    enableInterrupts();
+
     return 0;
 }
 
 /**************************************************************************
    Name - k_getpid
+
+   Returns - the pid of the running process
 *************************************************************************/
 int k_getpid()
 {
-    return 0;
+    return runningProcess->pid;
 }
 
 /**************************************************************************
    Name - k_join
-***************************************************************************/
-int k_join(int pid, int* pChildExitCode)
-{
-    return 0;
-}
 
-/**************************************************************************
-   Name - unblock
-*************************************************************************/
-int unblock(int pid)
-{
-    return 0;
-}
+   Purpose - Waits for another process to exit.  While waiting, the
+             target runs with at least the caller's priority.  When it
+             exits its joiners become ready in the order they joined.
 
-/*************************************************************************
-   Name - block
-*************************************************************************/
-int block(int newStatus)
+   Parameters - pid of the process to join, output for its exit code
+
+   Returns - 0, or
+        -1 if pid is the caller or no such process exists
+        -2 if pid is the caller's parent
+        -5 if the caller was signaled before the target exited
+
+***************************************************************************/
+int k_join(int pid, int* pChildExitCode)
 {
-    //checkKernelMode(__func__);
+    Process* pTarget;
+    unsigned int zombie;
 
-    int result = 0;
+    disableInterrupts();
 
-    if (newStatus <= 10)
+    pTarget = ProcessTableFind(pid);
+    if (pTarget == NULL && (zombie = ZombieFind(pid)) != 0)
     {
-        console_output(false, "block: function called with a reserved status value.\n");
-        stop(1);
+        /* Exited but not reaped yet. */
+        *pChildExitCode = ZombieFromNumber(zombie)->exitCode;
+        enableInterrupts();
+        return 0;
+    }
+    if (pTarget == NULL || pTarget == runningProcess)
+    {
+        enableInterrupts();
+        return -1;
+    }
+    if (pTarget == ProcessLink(runningProcess, pParent))
+    {
+        enableInterrupts();
+        return -2;
     }
 
-    disableInterrupts();
-    runningProcess->status = newStatus;
+    if (TakeSignals(runningProcess))
+    {
+        enableInterrupts();
+        return -5;
+    }
 
-    dispatcher(FALSE);
+    runningProcess->status = STATUS_BLOCKED_JOIN;
+    ProcessSetLink(runningProcess, pJoinTarget, pTarget);
+    JoinQueueAppend(&pTarget->joiners, runningProcess->index);
 
-    disableInterrupts();
-    if (signaled())
+    /* Only a joiner above what the target already inherits changes it,
+       so most joins do not walk the other joiners. */
+    if (runningProcess->priority > pTarget->inheritedPriority)
     {
-        DebugConsole("block(): Process signaled while blocked()\n");
-        result = -5;
+        UpdateInheritance(pTarget);
     }
-    //enableInterrupts();
 
-    return 0;
-}
-
-/*************************************************************************
-   Name - signaled
-*************************************************************************/
-int signaled()
-{
-    return 0;
-}
-/*************************************************************************
-   Name - readtime
-*************************************************************************/
-int read_time()
-{
-    return 0;
-}
+    dispatcher();
 
-/*************************************************************************
-   Name - readClock
-*************************************************************************/
-DWORD read_clock()
-{
-    return system_clock();
-}
+    /* The target's exit clears pJoinTarget; k_kill leaves it set. */
+    if (runningProcess->pJoinTarget != 0)
+    {
+        runningProcess->pJoinTarget = 0;
+        TakeSignals(runningProcess);
+        enableInterrupts();
+        return -5;
+    }
+    *pChildExitCode = runningProcess->joinExitCode;
 
-void display_process_table()
-{
+    enableInterrupts();
 
+    return 0;
 }
 
 /**************************************************************************
-   Name - GetNextPid
+   Name - k_wait_next_period
 
-   Purpose - 
+   Purpose - Ends the current job of a k_spawn_rt process and blocks
+             until its next period starts.  A signal does not cut the
+             wait short (see k_kill).
 
    Parameters - none
 
-   Returns - 
+   Returns - 0, or
+        -1 if the caller is not a real-time process
+        -5 if the process has been signaled, once the next job starts
 
 *************************************************************************/
-int GetNextPid()
+int k_wait_next_period()
 {
-    int newPid = -1;
-    int procSlot = nextPid % MAXPROC;
+    int result;
+
+    disableInterrupts();
 
-    if (processCount < MAXPROC)
+    if (runningProcess->rtPeriod == 0)
     {
-        while (processCount < MAXPROC && processTable[procSlot].status != STATUS_EMPTY)
-        {
-            nextPid++;
-            procSlot = nextPid % MAXPROC;
-        }
-        newPid = nextPid++;
+        enableInterrupts();
+        return -1;
     }
-    return newPid;
-}
 
-/* ---------------------------------------------------------------
-    ListInitialize
-
-    Purpose - Initialize a List type
-    Parameters - nextPrevOffset - offset from beginning of
-                structure to the next and previous pointers
-                with the structure that makes up the nodes
-    Returns - None
-    Side Effects -
---------------------------------------------------------------- */
-static void ListInitialize(List* pList)
-{
-    pList->pHead = pList->pTail = NULL;
-    pList->count = 0;
-}
+    if (!EdfCompleteJob(runningProcess, read_clock()))
+    {
+        runningProcess->status = STATUS_BLOCKED_PERIOD;
+    }
 
-/* ---------------------------------------------------------------
-    ListAddNode
-
-    Purpose - Adds a node to the end of the list
-    Parameters - List *pList - pointer to the list
-                TestStructure *pStructToAdd - pointer
-                to the structure to add
-    Returns - None
-    Side Effects -
---------------------------------------------------------------- */
-static void ListAddNode(List* pList, Process* pProcToAdd)
-{
-    //int listOffset;
+    /* Still running if the next job was already due; it then competes
+       with its new deadline. */
+    dispatcher();
+    result = TakeSignals(runningProcess) ? -5 : 0;
 
-    pProcToAdd->nextReadyProcess = NULL;
+    enableInterrupts();
 
-    if (pList->pHead == NULL)
-    {
-        // Set both the head and the tail pointer to the new node
-        pList->pHead = pList->pTail = pProcToAdd;
-    }
-    else
-    {
-        // Move the tail after pointing to it with current tail's pNext
-        pList->pTail->nextReadyProcess = pProcToAdd;
-        pList->pTail = pProcToAdd;
-    }
-    pList->count++;
+    return result;
 }
 
-/* ---------------------------------------------------------------
-    ListPopNodeEvens
+/**************************************************************************
+   Name - get_deadline_misses
 
-    Purpose - Removes the first node from the list and returns
-                a pointer to it
-    Parameters - List *pList - pointer to the list
-    Returns - A pointer to the removed node
-    Side Effects -
---------------------------------------------------------------- */
-static Process* ListPopNode(List* pList)
-{
-    Process* pNode = NULL;
+   Purpose - Reads the deadline-miss counter of a real-time process.
 
-    if (pList->count > 0)
-    {
-        pNode = pList->pHead;
-        pList->pHead = pNode->nextReadyProcess;
-        pList->count--;
+   Parameters - pid
 
-        // Clear prev and next
-        pNode->nextReadyProcess = NULL;
+   Returns - the number of jobs that finished after their deadline, or
+             -1 if pid is not a real-time process
 
-        // Clear the tail pointer if the list is now empty
-        if (pList->count == 0)
-        {
-            pList->pHead = pList->pTail = NULL;
-        }
+*************************************************************************/
+int get_deadline_misses(int pid)
+{
+    Process* pProc = ProcessTableFind(pid);
+
+    if (pProc == NULL || pProc->rtPeriod == 0)
+    {
+        return -1;
     }
-    return pNode;
+    return ProcessColdOf(pProc)->deadlineMisses;
 }
 
 /**************************************************************************
-   Name - AddToReadyList
+   Name - set_process_limit
 
-   Purpose -
+   Purpose - Sets how many processes can exist at once.  The table
+             grows in chunks as processes are spawned and gives chunks
+             back as they are reaped, so a high limit costs nothing
+             until it is used.
 
-   Parameters - none
+   Parameters - the limit, 1 to MAX_PROCESS_LIMIT (MAXPROC at boot)
+
+   Returns - the previous limit, or -1 if the limit is out of range or
+             below a process that is still in the table
+
+*************************************************************************/
+int set_process_limit(int limit)
+{
+    int result;
+
+    disableInterrupts();
+    result = ProcessTableSetLimit(limit);
+    enableInterrupts();
+
+    return result;
+}
+
+/**************************************************************************
+   Name - read_process_capacity
+
+   Returns - the number of process table slots currently allocated
+*************************************************************************/
+int read_process_capacity()
+{
+    return ProcessTableCapacity();
+}
+
+/**************************************************************************
+   Name - unblock
+
+   Purpose - Makes a process blocked in block() ready again.  It runs at
+             once if it outranks the caller.
+
+   Parameters - pid of the blocked process
+
+   Returns - 0, or
+        -1 if no such process exists
+        -2 if the process is not blocked in block()
+
+*************************************************************************/
+int unblock(int pid)
+{
+    Process* pProc;
+
+    disableInterrupts();
+
+    pProc = ProcessTableFind(pid);
+    if (pProc == NULL)
+    {
+        enableInterrupts();
+        return -1;
+    }
+
+    /* Statuses up to 10 are the kernel's own, block() only takes higher. */
+    if (pProc->status <= 10)
+    {
+        enableInterrupts();
+        return -2;
+    }
+
+    AddToReadyList(pProc);
+    dispatcher();
+
+    enableInterrupts();
+
+    return 0;
+}
+
+/*************************************************************************
+   Name - block
+*************************************************************************/
+int block(int newStatus)
+{
+    //checkKernelMode(__func__);
+
+    int result = 0;
+
+    if (newStatus <= 10)
+    {
+        console_output(false, "block: function called with a reserved status value.\n");
+        stop(1);
+    }
+
+    disableInterrupts();
+
+    /* A pending signal would never wake us again. */
+    if (!signaled())
+    {
+        runningProcess->status = newStatus;
+        dispatcher(FALSE);
+        disableInterrupts();
+    }
+
+    if (TakeSignals(runningProcess))
+    {
+        DebugConsole("block(): Process signaled while blocked()\n");
+        result = -5;
+    }
+    enableInterrupts();
+
+    return result;
+}
+
+/*************************************************************************
+   Name - signaled
+
+   Returns - TRUE if k_kill has signaled the running process and no
+             call has reported it yet
+*************************************************************************/
+int signaled()
+{
+    return runningProcess->pendingSignals != 0;
+}
+
+/* Clears the process's pending signals once a call reports them with
+   -5.  Returns TRUE if there were any. */
+static int TakeSignals(Process* pProc)
+{
+    if (pProc->pendingSignals == 0)
+    {
+        return FALSE;
+    }
+    pProc->pendingSignals = 0;
+    return TRUE;
+}
+/*************************************************************************
+   Name - read_time
+
+   Purpose - CPU time used so far by the running process, including the
+             current time slice.
+
+   Returns - the CPU time in milliseconds.  cpuTime is kept in 64 bits;
+             the int result is good for about 24 days of CPU.
+*************************************************************************/
+int read_time()
+{
+    return (int)((runningProcess->cpuTime + (DWORD)(read_clock() - runningProcess->sliceStart)) / 1000);
+}
+
+/*************************************************************************
+   Name - get_start_time
+
+   Returns - the time in microseconds at which the running process
+             started its current time slice
+*************************************************************************/
+int get_start_time()
+{
+    return (int)runningProcess->sliceStart;
+}
+
+/*************************************************************************
+   Name - readClock
+*************************************************************************/
+DWORD read_clock()
+{
+    return system_clock();
+}
+
+/*************************************************************************
+   Name - display_process_table
+
+   Purpose - Prints every non-empty process table entry.
+*************************************************************************/
+void display_process_table()
+{
+    static const char* statusNames[] = { "EMPTY", "READY", "RUNNING",
+        "BLOCKED_WAIT", "BLOCKED_JOIN", "EXITED", "BLOCKED_PERIOD" };
+    char statusBuffer[32];
+    uint64_t cpuTime;
+    unsigned int stackKb = 0;
+
+    console_output(FALSE, "%-11s%-11s%-10s%-14s%-10s%-10s%s\n",
+        "PID", "Parent", "Priority", "Status", "CPU(ms)", "Stack(KB)", "Name");
+
+    for (Process* pProc = ProcessTableNext(NULL); pProc != NULL; pProc = ProcessTableNext(pProc))
+    {
+        if (pProc->status <= STATUS_BLOCKED_PERIOD)
+        {
+            snprintf(statusBuffer, sizeof(statusBuffer), "%s", statusNames[pProc->status]);
+        }
+        else
+        {
+            snprintf(statusBuffer, sizeof(statusBuffer), "BLOCKED(%d)", pProc->status);
+        }
+
+        cpuTime = pProc->cpuTime;
+        if (pProc == runningProcess)
+        {
+            cpuTime += (DWORD)(read_clock() - pProc->sliceStart);
+        }
+
+        /* Stack(KB) is what the process has touched, not its stack size.
+           Only THREADSLinux can measure that; THREADS.lib shows 0. */
+#ifdef __linux__
+        stackKb = context_stack_resident(pProc->context) / 1024;
+#endif
+        console_output(FALSE, "%-11d%-11d%-10d%-14s%-10llu%-10u%s\n", pProc->pid,
+            pProc->pParent != 0 ? ProcessLink(pProc, pParent)->pid : -1,
+            pProc->priority, statusBuffer, (unsigned long long)(cpuTime / 1000),
+            stackKb, ProcessColdOf(pProc)->name);
+    }
+}
+
+/**************************************************************************
+   Name - UpdateInheritance
+
+   Purpose - Priority inheritance.  Recomputes the priority a process
+             inherits from the processes waiting on it (its joiners, and
+             its parent's childPriority, see SetChildPriority).  A higher
+             inherited priority raises the process; when the inheritance
+             drops it falls back to its k_spawn priority.  The change
+             follows the chain if the process is itself waiting.
+
+   Parameters - the process
+
+*************************************************************************/
+static void UpdateInheritance(Process* pProc)
+{
+    Process* pJoiner;
+    Process* pParent = ProcessLink(pProc, pParent);
+    int inherited = LOWEST_PRIORITY;
+    int priority;
+
+    if (pProc->status == STATUS_EMPTY || pProc->rtPeriod != 0)
+    {
+        return;
+    }
+
+    for (pJoiner = ProcessLink(pProc, joiners); pJoiner != NULL; pJoiner = ProcessLink(pJoiner, nextJoiner))
+    {
+        if (pJoiner->priority > inherited)
+        {
+            inherited = pJoiner->priority;
+        }
+    }
+    if (pParent != NULL && pParent->childPriority > inherited &&
+        (pParent->waitChild == 0 || pParent->waitChild == pProc->index))
+    {
+        inherited = pParent->childPriority;
+    }
+
+    if (inherited == pProc->inheritedPriority)
+    {
+        return;
+    }
+    if (inherited > pProc->inheritedPriority)
+    {
+        priority = inherited > pProc->priority ? inherited : pProc->priority;
+    }
+    else
+    {
+        priority = inherited > pProc->basePriority ? inherited : pProc->basePriority;
+    }
+    pProc->inheritedPriority = inherited;
+    ChangePriority(pProc, priority);
+}
+
+/* Applies UpdateInheritance to every live child of pParent. */
+static void InheritFromParent(Process* pParent)
+{
+    for (Process* pProc = ProcessLink(pParent, pChildren); pProc != NULL;
+         pProc = ProcessLink(pProc, nextSiblingProcess))
+    {
+        UpdateInheritance(pProc);
+    }
+}
+
+/* ---------------------------------------------------------------
+    SetChildPriority
+
+    Purpose - Sets the priority the children of pParent inherit from
+                its k_waitpid, LOWEST_PRIORITY for none, for one child
+                or for all of them with child 0, and passes a change on
+                to the children it covered and now covers.  The priority
+                is set when the parent blocks in k_waitpid and kept when
+                a child's exit wakes it; the dispatcher and the clock
+                tick drop it once the parent runs on without waiting
+                again.  A parent reaping its children one by one so only
+                walks them at its first wait.
+--------------------------------------------------------------- */
+static void SetChildPriority(Process* pParent, int priority, ProcessIndex child)
+{
+    int oldPriority = pParent->childPriority;
+    ProcessIndex oldChild = pParent->waitChild;
+
+    if (oldPriority == priority && oldChild == child)
+    {
+        return;
+    }
+    pParent->childPriority = (unsigned short)priority;
+    pParent->waitChild = child;
+
+    if ((oldPriority != LOWEST_PRIORITY && oldChild == 0) ||
+        (priority != LOWEST_PRIORITY && child == 0))
+    {
+        InheritFromParent(pParent);
+        return;
+    }
+    if (oldPriority != LOWEST_PRIORITY)
+    {
+        UpdateInheritance(ProcessFromIndex(oldChild));
+    }
+    if (priority != LOWEST_PRIORITY)
+    {
+        UpdateInheritance(ProcessFromIndex(child));
+    }
+}
+
+/* Children outlive their parent as orphans: nobody waits for them and
+   they leave no exit record. */
+static void OrphanChildren(Process* pParent)
+{
+    Process* pProc;
+
+    while ((pProc = ProcessLink(pParent, pChildren)) != NULL)
+    {
+        pParent->pChildren = pProc->nextSiblingProcess;
+        pProc->pParent = pProc->nextSiblingProcess = pProc->prevSiblingProcess = 0;
+    }
+}
+
+/* ---------------------------------------------------------------
+    AddChild / RemoveChild
+
+    Purpose - Link a process into or out of its parent's list of
+                live children in constant time.  The list stays in
+                spawn order, which is the order inheritance requeues
+                children in.
+--------------------------------------------------------------- */
+static void AddChild(Process* pParent, Process* pChild)
+{
+    ProcessSetLink(pChild, pParent, pParent);
+    ChildListAppend(&pParent->pChildren, pChild->index);
+}
+
+static void RemoveChild(Process* pParent, Process* pChild)
+{
+    ChildListRemove(&pParent->pChildren, pChild->index);
+    pChild->pParent = 0;
+}
+
+/**************************************************************************
+   Name - ChangePriority
+
+   Purpose - Sets the effective priority of a process, moving it between
+             run queues if it is ready, and passes the change on to the
+             process it is joined with or, in k_wait, to its children.
+
+*************************************************************************/
+static void ChangePriority(Process* pProc, int priority)
+{
+    if (pProc->priority == priority)
+    {
+        return;
+    }
+
+    if (pProc->status == STATUS_READY && schedulerPolicy->dequeue(pProc))
+    {
+        pProc->priority = priority;
+        schedulerPolicy->enqueue(pProc);
+    }
+    else
+    {
+        pProc->priority = priority;
+    }
+
+    if (pProc->status == STATUS_BLOCKED_JOIN && pProc->pJoinTarget != 0)
+    {
+        UpdateInheritance(ProcessLink(pProc, pJoinTarget));
+    }
+    else if (pProc->status == STATUS_BLOCKED_WAIT)
+    {
+        SetChildPriority(pProc, priority, pProc->waitChild);
+    }
+}
+
+/* ---------------------------------------------------------------
+    ReleaseProcessSlot
+
+    Purpose - Frees the context and strings of a finished process
+                and returns its table slot to the allocator
+--------------------------------------------------------------- */
+static void ReleaseProcessSlot(Process* pProc)
+{
+    context_stop(pProc->context);
+    ReleaseProcessStrings(pProc);
+    ProcessTableRelease(pProc);
+}
+
+/* Drops the process's references to its name and arguments. */
+static void ReleaseProcessStrings(Process* pProc)
+{
+    ProcessCold* pCold = ProcessColdOf(pProc);
+
+    StringArenaRelease(pCold->name);
+    StringArenaRelease(pCold->startArgs);
+    pCold->name = pCold->startArgs = NULL;
+}
+
+/**************************************************************************
+   Name - AddToReadyList
+
+   Purpose - Marks the process ready and hands it to the scheduling
+             policy, or to the real-time class for a k_spawn_rt process.
+             A policy process that was not running (new or blocked) is
+             passed to the policy's on_wake hook first.
+
+   Parameters - the process to add
 
    Returns - nothing
 
 *************************************************************************/
 void AddToReadyList(Process* pProcess)
 {
-    int priority;
+    if (pProcess->priority != LOWEST_PRIORITY)
+    {
+        readyCount++;
+    }
 
-    pProcess->status = STATUS_READY;
+    if (pProcess->rtPeriod != 0)
+    {
+        pProcess->status = STATUS_READY;
+        EdfEnqueue(pProcess);
+        return;
+    }
 
-    priority = pProcess->priority;
+    if (pProcess->status != STATUS_RUNNING && schedulerPolicy->on_wake != NULL)
+    {
+        schedulerPolicy->on_wake(pProcess);
+    }
 
-    // Add to the ready list based on priority
-    //readyList[priority] = pProcess; // Add to tail of list
-    ListAddNode(&readyList[priority], &pProcess);
+    pProcess->status = STATUS_READY;
+    schedulerPolicy->enqueue(pProcess);
 }
 
 /**************************************************************************
    Name - GetNextReadyProc
 
-   Purpose - 
+   Purpose - Picks the process to run next.  A released real-time
+             process comes first; the scheduling policy is only asked
+             when no real-time process is running or ready.
 
    Parameters - none
 
-   Returns - nothing
+   Returns - the process to run next, or NULL to keep the current one
 
 *************************************************************************/
 Process* GetNextReadyProc()
 {
-    int higherThanPriority = LOWEST_PRIORITY;
-    Process* nextProcess = NULL;
+    Process* nextProcess = EdfPickNext(runningProcess);
 
-    if (runningProcess != NULL && runningProcess->status == STATUS_RUNNING)
+    if (nextProcess == NULL &&
+        (runningProcess == NULL || runningProcess->rtPeriod == 0 ||
+         runningProcess->status != STATUS_RUNNING))
     {
-        higherThanPriority = runningProcess->priority;
+        nextProcess = schedulerPolicy->pick_next(runningProcess);
     }
-
-    for (int i = HIGHEST_PRIORITY; i >= higherThanPriority; --i)
+    if (nextProcess != NULL && nextProcess->priority != LOWEST_PRIORITY)
     {
-        if (readyList[i].count > 0)
-        {
-            //nextProcess = readyList[i]; // Pop from ready list
-            //readyList[i] = NULL; // Pop simulating
-            nextProcess = ListPopNode(&readyList[i]);
-            break;
-        }
+        readyCount--;
     }
-
     return nextProcess;
 }
 
 /**************************************************************************
    Name - time_slice
 
-   Purpose -
+   Purpose - Releases real-time jobs whose period has started, then
+             preempts the running process for an earlier deadline or
+             passes the tick to the scheduling policy.  Real-time
+             processes are not time sliced, but are throttled once the
+             current job has used its runtime.
 
    Parameters - none
 
@@ -593,14 +1347,286 @@ Process* GetNextReadyProc()
 *************************************************************************/
 void  time_slice(void)
 {
-    // If the current process has been running for 80ms or more, do something
+    Process* pProc = runningProcess;
+    DWORD now = read_clock();
+
+    readyCount += EdfReleaseJobs(now);
+
+    if (pProc == NULL || pProc->status != STATUS_RUNNING)
+    {
+        ProgramTimer();
+        return;
+    }
+
+    /* A parent still running after k_waitpid returned is done waiting. */
+    if (pProc->childPriority != LOWEST_PRIORITY)
+    {
+        SetChildPriority(pProc, LOWEST_PRIORITY, 0);
+    }
+
+    /* A real-time job past its runtime waits for its next release. */
+    if (pProc->rtPeriod != 0 && EdfThrottle(pProc, now))
+    {
+        dispatcher();
+        return;
+    }
+
+    if (EdfPreempts(pProc) ||
+        (pProc->rtPeriod == 0 && schedulerPolicy->tick(pProc, now)))
+    {
+        AddToReadyList(pProc);
+        dispatcher();
+    }
+    else
+    {
+        ProgramTimer();
+    }
+}
+
+/**************************************************************************
+   Name - ChargeSlice
+
+   Purpose - Charges a process for the CPU it used since sliceStart and
+             starts a new slice.  The policy's charge hook sees the same
+             amount.
+
+*************************************************************************/
+void ChargeSlice(Process* pProc, DWORD now)
+{
+    int ran = (int)(now - pProc->sliceStart);
+
+    pProc->cpuTime += ran;
+    if (pProc->rtPeriod != 0)
+    {
+        EdfCharge(pProc, ran);
+    }
+    if (schedulerPolicy->charge != NULL)
+    {
+        schedulerPolicy->charge(pProc, ran);
+    }
+    pProc->sliceStart = now;
+}
+
+/**************************************************************************
+   Name - SchedulerSetPolicy
+
+   Purpose - Makes a policy the active one.  The ready processes are
+             drained from the old policy and enqueued in the new one in
+             the order the old policy would have run them.
+
+   Parameters - the new policy
+
+   Returns - nothing
+
+*************************************************************************/
+void SchedulerSetPolicy(const SchedulerPolicy* pPolicy)
+{
+    List pending;
+    Process* pProc;
+
+    disableInterrupts();
+    if (pPolicy != schedulerPolicy)
+    {
+        ListInitialize(&pending);
+        while ((pProc = schedulerPolicy->pick_next(NULL)) != NULL)
+        {
+            ListAddNode(&pending, pProc);
+        }
+        if (schedulerPolicy->stop != NULL)
+        {
+            schedulerPolicy->stop();
+        }
+
+        schedulerPolicy = pPolicy;
+        if (schedulerPolicy->start != NULL)
+        {
+            schedulerPolicy->start();
+        }
+        while ((pProc = ListPopNode(&pending)) != NULL)
+        {
+            schedulerPolicy->enqueue(pProc);
+        }
+    }
+    if (!booting)
+    {
+        enableInterrupts();
+    }
+}
+
+/**************************************************************************
+   Name - set_scheduler_policy
+
+   Purpose - Selects the scheduling policy by name.
+
+   Parameters - "priority", "mlfq", "cfs" or "stride"
+
+   Returns - 0, or -1 if there is no policy with that name
+
+*************************************************************************/
+int set_scheduler_policy(char* name)
+{
+    for (int i = 0; i < (int)(sizeof(policies) / sizeof(policies[0])); ++i)
+    {
+        if (strcmp(policies[i]->name, name) == 0)
+        {
+            SchedulerSetPolicy(policies[i]);
+            return 0;
+        }
+    }
+    return -1;
+}
+
+/**************************************************************************
+   Name - set_time_slice
+
+   Purpose - Sets the time slice used for processes at a priority.
+
+   Parameters - priority, slice length in milliseconds (> 0)
+
+   Returns - the previous slice length, or -1 for a bad argument
+
+*************************************************************************/
+int set_time_slice(int priority, int milliseconds)
+{
+    int previous;
+
+    if (priority < LOWEST_PRIORITY || priority > HIGHEST_PRIORITY || milliseconds <= 0)
+    {
+        return -1;
+    }
+
+    previous = timeSlice[priority];
+    timeSlice[priority] = milliseconds;
+    return previous;
+}
+
+/**************************************************************************
+   Name - set_tickless
+
+   Purpose - Switches the clock between the periodic tick and one-shot
+             programming for the next scheduling event.
+
+   Parameters - enabled
+
+   Returns - the previous setting, or -1 if the clock device does not
+             support one-shot mode
+
+*************************************************************************/
+int set_tickless(int enabled)
+{
+    int previous = ticklessEnabled;
+    device_control_block_t control = { 0 };
 
+    control.command = CLOCK_SET_TIMER;
+    control.control1 = enabled ? CLOCK_ONE_SHOT : CLOCK_PERIODIC;
+
+    disableInterrupts();
+    if (device_control("clock", control) != 0)
+    {
+        previous = -1;
+    }
+    else
+    {
+        ticklessEnabled = enabled;
+        timerArmed = FALSE;
+        ProgramTimer();
+    }
+    if (!booting)
+    {
+        enableInterrupts();
+    }
+
+    return previous;
+}
+
+/**************************************************************************
+   Name - read_interrupt_count
+
+   Returns - the number of clock interrupts taken since bootstrap
+*************************************************************************/
+unsigned int read_interrupt_count()
+{
+    return timerInterrupts;
+}
+
+/**************************************************************************
+   Name - read_interrupt_rate
+
+   Returns - clock interrupts per second, averaged since bootstrap
+*************************************************************************/
+int read_interrupt_rate()
+{
+    DWORD elapsed = read_clock();
+
+    return elapsed == 0 ? 0 : (int)((uint64_t)timerInterrupts * 1000000 / elapsed);
+}
+
+/**************************************************************************
+   Name - ProgramTimer
+
+   Purpose - In tickless mode, programs the one-shot clock for the next
+             event: the end of the running process's slice if another
+             process is ready, the end of a running real-time job's
+             budget, or the next real-time release, whichever is first.  The clock is left alone if it is already set for
+             that time, and disarmed if there is no event.
+
+*************************************************************************/
+static void ProgramTimer(void)
+{
+    device_control_block_t control = { 0 };
+    DWORD now, expiry = 0, release;
+    int armed = FALSE;
+    uint32_t delay = 0;
+
+    if (!ticklessEnabled)
+    {
+        return;
+    }
+
+    /* Real-time processes are not sliced, but stop at the end of the
+       job's budget. */
+    if (runningProcess != NULL && runningProcess->status == STATUS_RUNNING)
+    {
+        if (runningProcess->rtPeriod != 0)
+        {
+            expiry = runningProcess->sliceStart + runningProcess->rtBudget;
+            armed = TRUE;
+        }
+        else if (readyCount > 0)
+        {
+            expiry = runningProcess->sliceStart + timeSlice[runningProcess->priority] * 1000;
+            armed = TRUE;
+        }
+    }
+    if (EdfNextRelease(&release) && (!armed || (int)(release - expiry) < 0))
+    {
+        expiry = release;
+        armed = TRUE;
+    }
+
+    if (armed == timerArmed && (!armed || expiry == timerExpiry))
+    {
+        return;
+    }
+
+    if (armed)
+    {
+        now = read_clock();
+        delay = (int)(expiry - now) > 0 ? expiry - now : 1;
+    }
+    control.command = CLOCK_SET_TIMER;
+    control.control1 = CLOCK_ONE_SHOT;
+    control.input_data = &delay;
+    device_control("clock", control);
+
+    timerArmed = armed;
+    timerExpiry = expiry;
 }
 
 /**************************************************************************
    Name - timer_interrupt_handler
 
-   Purpose -
+   Purpose - Clock interrupt; drives time slicing.
 
    Parameters - none
 
@@ -609,6 +1635,8 @@ void  time_slice(void)
 *************************************************************************/
 void timer_interrupt_handler(char deviceId[32], uint8_t command, uint32_t status)
 {
+    timerInterrupts++;
+    timerArmed = FALSE;
     time_slice();
 }
 
@@ -625,6 +1653,15 @@ void timer_interrupt_handler(char deviceId[32], uint8_t command, uint32_t status
 void dispatcher()
 {
     Process *nextProcess = NULL;
+    DWORD now;
+
+    /* A parent giving up the CPU for anything but another k_waitpid is
+       done waiting, so its children lose its priority. */
+    if (runningProcess != NULL && runningProcess->childPriority != LOWEST_PRIORITY &&
+        runningProcess->status != STATUS_BLOCKED_WAIT)
+    {
+        SetChildPriority(runningProcess, LOWEST_PRIORITY, 0);
+    }
 
     nextProcess = GetNextReadyProc();
     //nextProcess = &processTable[2];
@@ -632,14 +1669,42 @@ void dispatcher()
     // Next process is null if the current process should remain running
     if (nextProcess != NULL)
     {
+        now = read_clock();
+
+        if (runningProcess != NULL)
+        {
+            /* Charge the outgoing process for its slice.  After k_exit
+               there is no outgoing process. */
+            if (runningProcess->status > STATUS_RUNNING && schedulerPolicy->on_block != NULL)
+            {
+                /* k_join and k_waitpid lent the old priority; pass the
+                   new one on to what the process waits on. */
+                ChangePriority(runningProcess, schedulerPolicy->on_block(runningProcess, now));
+            }
+            ChargeSlice(runningProcess, now);
+
+            /* A preempted process goes back on the run queue. */
+            if (runningProcess->status == STATUS_RUNNING)
+            {
+                AddToReadyList(runningProcess);
+            }
+        }
+
         /* IMPORTANT: context switch enables interrupts. */
         runningProcess = nextProcess;
 
         // Set the status of the next process to running
         runningProcess->status = STATUS_RUNNING;
+        runningProcess->sliceStart = now;
 
+        ProgramTimer();
         context_switch(runningProcess->context);
     }
+    else
+    {
+        /* The ready set may have changed without a switch (k_spawn). */
+        ProgramTimer();
+    }
 
 } 
 
@@ -667,7 +1732,16 @@ static int watchdog(char* dummy)
 /* check to determine if deadlock has occurred... */
 static void check_deadlock()
 {
+    DWORD release;
+
+    /* Not idle for good while the clock still has real-time jobs to release. */
+    if (EdfNextRelease(&release))
+    {
+        return;
+    }
+
     // TODO: If there are no other processes in the system, then stop
+    display_stack_profile();
     console_output(false, "All processes completed.");
     stop(0);
 }
@@ -689,6 +1763,14 @@ static inline void disableInterrupts()
 
 } /* disableInterrupts */
 
+/*
+ * Enables the interrupts.
+ */
+static inline void enableInterrupts()
+{
+    set_psr(get_psr() | PSR_INTERRUPTS);
+}
+
 /**************************************************************************
    Name - DebugConsole
    Purpose - Prints  the message to the console_output if in debug mode
@@ -0,0 +1,106 @@
+#include <stdio.h>
+#include "THREADSLib.h"
+#include "SchedulerTesting.h"
+#include "Scheduler.h"
+#include "../Processes.h"
+#include "../ProcessHeap.h"
+#include "../ProcessTable.h"
+
+#define BENCH_OPERATIONS 1000000
+
+static void BenchHeap(char* testName, int processCount);
+
+/*********************************************************************************
+*
+* SchedulerBenchCfs
+*
+* Measures the fair scheduler's run queue (ProcessHeap) with 1,000 and 10,000
+* runnable processes.  Each operation is what the dispatcher does per switch
+* in fair mode: pop the process with the least virtual runtime, charge it a
+* weighted slice and insert it again.  Pop and insert are timed separately.
+*
+* The heap links processes by table index, so the records are taken straight
+* from the process table (with its limit raised) without spawning them.
+*
+*********************************************************************************/
+int SchedulerEntryPoint(void* pArgs)
+{
+    char* testName = "SchedulerBenchCfs";
+
+    console_output(FALSE, "\n%s: started\n", testName);
+
+    BenchHeap(testName, 1000);
+    BenchHeap(testName, 10000);
+
+    k_exit(0);
+
+    return 0;
+}
+
+static void BenchHeap(char* testName, int processCount)
+{
+    ProcessHeap heap;
+    Process** pProcs;
+    Process* pProc;
+    Process** pPopped;
+    unsigned int startTime, popTime = 0, insertTime = 0;
+    int batch = 1000;
+
+    set_process_limit(processCount + MAXPROC);
+    pProcs = calloc(processCount, sizeof(Process*));
+    pPopped = calloc(batch, sizeof(Process*));
+    if (pProcs == NULL || pPopped == NULL)
+    {
+        console_output(FALSE, "%s: out of memory\n", testName);
+        stop(1);
+    }
+
+    ProcessHeapInitialize(&heap);
+    for (int i = 0; i < processCount; ++i)
+    {
+        pProcs[i] = ProcessTableAllocate();
+        if (pProcs[i] == NULL)
+        {
+            console_output(FALSE, "%s: process table full\n", testName);
+            stop(1);
+        }
+        /* Weights 1..5 spread the keys the way mixed priorities would. */
+        pProcs[i]->priority = 1 + i % 5;
+        pProcs[i]->sortKey = (uint64_t)((i * 7919) % processCount) * 100;
+        ProcessHeapInsert(&heap, pProcs[i]);
+    }
+
+    /* Work in batches so the clock reads do not dominate. */
+    for (int done = 0; done < BENCH_OPERATIONS; done += batch)
+    {
+        startTime = system_clock();
+        for (int i = 0; i < batch; ++i)
+        {
+            pPopped[i] = ProcessHeapPop(&heap);
+        }
+        popTime += system_clock() - startTime;
+
+        for (int i = 0; i < batch; ++i)
+        {
+            pProc = pPopped[i];
+            pProc->sortKey += 80000 * 1024 / (800 + 100 * pProc->priority);
+        }
+
+        startTime = system_clock();
+        for (int i = 0; i < batch; ++i)
+        {
+            ProcessHeapInsert(&heap, pPopped[i]);
+        }
+        insertTime += system_clock() - startTime;
+    }
+
+    console_output(FALSE, "%s: %6d runnable: pick %7.1f ns, insert %7.1f ns\n", testName,
+        processCount, popTime * 1000.0 / BENCH_OPERATIONS, insertTime * 1000.0 / BENCH_OPERATIONS);
+
+    for (int i = 0; i < processCount; ++i)
+    {
+        ProcessTableRelease(pProcs[i]);
+    }
+    free(pPopped);
+    free(pProcs);
+}
@@ -0,0 +1,106 @@
+#include <stdio.h>
+#include "THREADSLib.h"
+#include "SchedulerTesting.h"
+#include "Scheduler.h"
+#include "../Processes.h"
+
+#define BENCH_ITERATIONS 1000000
+
+/* Kernel internals exercised directly by the benchmark. */
+extern Process* runningProcess;
+extern List readyList[];
+extern Process* GetNextReadyProc();
+extern void AddToReadyList(Process* pProcess);
+extern Process* PriorityPickNext(Process* pRunning);
+extern Process* ListPopNode(List* pList);
+extern void ListAddNode(List* pList, Process* pProcToAdd);
+
+/*********************************************************************************
+*
+* SchedulerBenchDispatch
+*
+* Measures the cost of selecting the next ready process.  A single child is
+* parked at the lowest schedulable priority, which is the worst case for a
+* top-down walk of readyList[].  Each iteration selects, pops and requeues
+* it, once with the readyBitmap bit scan (PriorityPickNext) and once with
+* the old linear walk over the list counts; both pop with ListPopNode() and
+* requeue with ListAddNode(), so only the selection differs.  The whole
+* kernel path, GetNextReadyProc() and AddToReadyList(), is timed as well.
+*
+* Build with different HIGHEST_PRIORITY values (up to 31) to see that the
+* bitmap selection stays flat as the number of priority levels grows.  With
+* one process always at the same level the linear walk's branches are
+* perfectly predicted, so this is its best case in time even though it is
+* the worst case in steps.
+*
+*********************************************************************************/
+int SchedulerEntryPoint(void* pArgs)
+{
+    char* testName = "SchedulerBenchDispatch";
+    char nameBuffer[512];
+    int status = -1, kidpid;
+    int savedStatus;
+    volatile int sink = 0;
+    const volatile List* pLists = readyList;
+    Process* pProc;
+    unsigned int startTime, bitmapTime, linearTime, kernelTime;
+
+    console_output(FALSE, "\n%s: started, %d priority levels\n", testName, HIGHEST_PRIORITY + 1);
+
+    snprintf(nameBuffer, sizeof(nameBuffer), "%s-Child1", testName);
+    kidpid = k_spawn(nameBuffer, SimpleDelayExit, nameBuffer, THREADS_MIN_STACK_SIZE, LOWEST_PRIORITY + 1);
+
+    /* Stay on the CPU while the lists are being churned. */
+    set_psr(get_psr() & ~PSR_INTERRUPTS);
+    savedStatus = runningProcess->status;
+    runningProcess->status = STATUS_READY;
+
+    startTime = system_clock();
+    for (int i = 0; i < BENCH_ITERATIONS; ++i)
+    {
+        pProc = PriorityPickNext(NULL);
+        ListAddNode(&readyList[pProc->priority], pProc);
+    }
+    bitmapTime = system_clock() - startTime;
+
+    startTime = system_clock();
+    for (int i = 0; i < BENCH_ITERATIONS; ++i)
+    {
+        int priority;
+        for (priority = HIGHEST_PRIORITY; priority > LOWEST_PRIORITY; --priority)
+        {
+            if (pLists[priority].count > 0)
+            {
+                break;
+            }
+        }
+        sink += priority;
+        pProc = ListPopNode(&readyList[priority]);
+        ListAddNode(&readyList[priority], pProc);
+    }
+    linearTime = system_clock() - startTime;
+
+    startTime = system_clock();
+    for (int i = 0; i < BENCH_ITERATIONS; ++i)
+    {
+        pProc = GetNextReadyProc();
+        AddToReadyList(pProc);
+    }
+    kernelTime = system_clock() - startTime;
+
+    runningProcess->status = savedStatus;
+
+    console_output(FALSE, "%s: bitmap select+pop+requeue %8.1f ns\n", testName,
+        bitmapTime * 1000.0 / BENCH_ITERATIONS);
+    console_output(FALSE, "%s: linear select+pop+requeue %8.1f ns\n", testName,
+        linearTime * 1000.0 / BENCH_ITERATIONS);
+    console_output(FALSE, "%s: kernel dispatch path      %8.1f ns\n", testName,
+        kernelTime * 1000.0 / BENCH_ITERATIONS);
+
+    kidpid = k_wait(&status);
+    console_output(FALSE, "%s: exit status for child %d is %d\n", testName, kidpid, status);
+
+    k_exit(0);
+
+    return 0;
+}
@@ -0,0 +1,110 @@
+#include <stdio.h>
+#include "THREADSLib.h"
+#include "SchedulerTesting.h"
+#include "Scheduler.h"
+
+#define MAX_JOINERS 1000
+
+int Target(char* strArgs);
+int Joiner(char* strArgs);
+
+static int targetPid;
+static int joinerCount;
+static int wokenCount;
+static unsigned int exitTime;
+static unsigned int firstWakeTotal;
+static unsigned int allWakeTotal;
+static unsigned int spawnJoinTotal;
+
+/*********************************************************************************
+*
+* SchedulerBenchJoin
+*
+* Measures waking every process joined with one that exits, for 1, 10 and
+* 1000 joiners.  Each round spawns a low priority target, then the joiners
+* at this process's priority, and joins the target last.  The joiners run
+* in turn and block in k_join, lending the target their priority, and the
+* target exits once they have all joined.  The first joiner to run after
+* that gives the latency to the first wake, and the last one the latency
+* until every joiner has run; they are woken ahead of this process, which
+* joined last.  The time to spawn a joiner and have it join is shown as
+* well.
+*
+*********************************************************************************/
+int SchedulerEntryPoint(void* pArgs)
+{
+    char* testName = "SchedulerBenchJoin";
+    static const int counts[] = { 1, 10, MAX_JOINERS };
+    static const int rounds[] = { 10000, 2000, 50 };
+    int status = -1;
+    unsigned int startTime;
+
+    console_output(FALSE, "\n%s: started\n", testName);
+    set_process_limit(MAX_JOINERS + 8);
+
+    for (int i = 0; i < (int)(sizeof(counts) / sizeof(counts[0])); ++i)
+    {
+        joinerCount = counts[i];
+        firstWakeTotal = allWakeTotal = spawnJoinTotal = 0;
+
+        for (int round = 0; round < rounds[i]; ++round)
+        {
+            wokenCount = 0;
+            targetPid = k_spawn("Target", Target, NULL, THREADS_MIN_STACK_SIZE, LOWEST_PRIORITY + 1);
+            startTime = system_clock();
+            for (int j = 0; j < joinerCount; ++j)
+            {
+                k_spawn("Joiner", Joiner, NULL, THREADS_MIN_STACK_SIZE, HIGHEST_PRIORITY);
+            }
+            k_join(targetPid, &status);
+            spawnJoinTotal += exitTime - startTime;
+            for (int j = 0; j <= joinerCount; ++j)
+            {
+                k_wait(&status);
+            }
+        }
+
+        console_output(FALSE, "%s: %4d joiners: first wake %8.2f us, all woken %9.2f us, spawn+join %6.2f us\n",
+            testName, joinerCount, (double)firstWakeTotal / rounds[i], (double)allWakeTotal / rounds[i],
+            (double)spawnJoinTotal / rounds[i] / joinerCount);
+    }
+    console_output(FALSE, "%s: done\n", testName);
+
+    k_exit(0);
+
+    return 0;
+}
+
+/*
+*  Target - exits as soon as it runs, which is once everyone has joined.
+*/
+int Target(char* strArgs)
+{
+    exitTime = system_clock();
+    k_exit(0);
+
+    return 0;
+}
+
+/*
+*  Joiner - joins the target and records when it is woken.
+*/
+int Joiner(char* strArgs)
+{
+    int status = -1;
+    unsigned int now;
+
+    k_join(targetPid, &status);
+    now = system_clock();
+    if (wokenCount++ == 0)
+    {
+        firstWakeTotal += now - exitTime;
+    }
+    if (wokenCount == joinerCount)
+    {
+        allWakeTotal += now - exitTime;
+    }
+    k_exit(0);
+
+    return 0;
+}
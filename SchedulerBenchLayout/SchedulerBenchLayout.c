@@ -0,0 +1,321 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <malloc.h>
+#include <string.h>
+#include "THREADSLib.h"
+#include "SchedulerTesting.h"
+#include "Scheduler.h"
+#include "../Processes.h"
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+#define BENCH_PROCESSES  32768
+#define BENCH_ROUNDS     50
+
+/* The PCB before it was split: names and arguments inline, pointer links
+   and the dispatch fields spread out behind the strings. */
+#define LEGACY_MAXNAME   256
+#define LEGACY_MAXARG    256
+
+typedef struct _legacy_process
+{
+    struct _legacy_process* nextReadyProcess;
+    struct _legacy_process* nextSiblingProcess;
+    struct _legacy_process* pParent;
+    struct _legacy_process* pChildren;
+    struct _legacy_process* pActiveChildren;
+    struct _legacy_process* pExitingChildren;
+    struct _legacy_process* pJoiners;
+    char           name[LEGACY_MAXNAME];
+    char           startArgs[LEGACY_MAXARG];
+    void*          context;
+    int            pid;
+    unsigned short generation;
+    int            priority;
+    int            basePriority;
+    int            inheritedPriority;
+    int (*entryPoint) (void*);
+    int            status;
+    DWORD          sliceStart;
+    int            cpuTime;
+    uint64_t       vruntime;
+    uint64_t       sortKey;
+    struct _legacy_process* pHeapChild;
+    struct _legacy_process* pHeapNext;
+    struct _legacy_process* pHeapPrev;
+    int            tickets;
+    uint64_t       pass;
+    int            rtRuntime;
+    int            rtDeadline;
+    int            rtPeriod;
+    DWORD          rtAbsDeadline;
+    DWORD          rtNextRelease;
+    int            deadlineMisses;
+    struct _legacy_process* nextRealtimeProcess;
+    struct _legacy_process* pJoinTarget;
+    struct _legacy_process* nextJoiner;
+    int            joinExitCode;
+    int            exitCode;
+} LegacyProcess;
+
+/* Kernel internals exercised directly by the benchmark. */
+extern Process* runningProcess;
+extern Process* GetNextReadyProc();
+extern void AddToReadyList(Process* pProcess);
+
+static int OpenCacheMissCounter(void);
+static long long ReadCounter(int fd);
+static void ShuffleOrder(int* pOrder, int count);
+static void FreeAligned(void* pMemory);
+static void CompareLayouts(char* testName, int count, int counter);
+int QuickExit(char* strArgs);
+
+/*********************************************************************************
+*
+* SchedulerBenchLayout
+*
+* Measures how the layout of the process control block affects dispatching.
+* 32768 processes wait at one priority level and each iteration moves the one
+* at the head of the ready list to the tail, as a dispatch does.  Every
+* iteration touches a different PCB, so once the hot fields of all of them no
+* longer fit in the cache the cost is set by how many cache lines of each PCB
+* the ready path reads.
+*
+* The same ready-list walk is then timed over two private arrays of PCBs,
+* one with the current layout and one with the layout from before the PCB
+* was split (name and arguments inline, 736 bytes on x86-64), linked in the same
+* shuffled order so that only the layout differs.
+*
+* Cache misses come from the hardware counter where Linux perf events are
+* available; otherwise only the time is reported.
+*
+*********************************************************************************/
+int SchedulerEntryPoint(void* pArgs)
+{
+    char* testName = "SchedulerBenchLayout";
+    char nameBuffer[512];
+    int status = -1, spawned = 0;
+    int savedStatus;
+    int counter;
+    long long misses;
+    unsigned int startTime, elapsed;
+    int iterations;
+    Process* pProc;
+
+    console_output(FALSE, "\n%s: started, sizeof(Process) %d bytes\n", testName, (int)sizeof(Process));
+
+    set_process_limit(BENCH_PROCESSES + 2);
+    for (int i = 0; i < BENCH_PROCESSES; ++i)
+    {
+        snprintf(nameBuffer, sizeof(nameBuffer), "%s-Child%d", testName, i + 1);
+        if (k_spawn(nameBuffer, QuickExit, nameBuffer, THREADS_MIN_STACK_SIZE, LOWEST_PRIORITY + 1) > 0)
+        {
+            spawned++;
+        }
+    }
+
+    /* Stay on the CPU while the list is being churned. */
+    set_psr(get_psr() & ~PSR_INTERRUPTS);
+    savedStatus = runningProcess->status;
+    runningProcess->status = STATUS_READY;
+
+    /* One pass to settle, then the measured rounds. */
+    for (int i = 0; i < spawned; ++i)
+    {
+        AddToReadyList(GetNextReadyProc());
+    }
+
+    iterations = spawned * BENCH_ROUNDS;
+    counter = OpenCacheMissCounter();
+    misses = ReadCounter(counter);
+    startTime = system_clock();
+    for (int i = 0; i < iterations; ++i)
+    {
+        pProc = GetNextReadyProc();
+        AddToReadyList(pProc);
+    }
+    elapsed = system_clock() - startTime;
+    misses = ReadCounter(counter) - misses;
+
+    runningProcess->status = savedStatus;
+
+    console_output(FALSE, "%s: %d processes, %8.1f ns per dispatch\n", testName, spawned,
+        elapsed * 1000.0 / iterations);
+    if (counter >= 0)
+    {
+        console_output(FALSE, "%s: %8.2f cache misses per dispatch\n", testName,
+            (double)misses / iterations);
+    }
+    else
+    {
+        console_output(FALSE, "%s: cache miss counter not available\n", testName);
+    }
+
+    CompareLayouts(testName, spawned, counter);
+
+    for (int i = 0; i < spawned; ++i)
+    {
+        k_wait(&status);
+    }
+
+    k_exit(0);
+
+    return 0;
+}
+
+/*
+*  QuickExit - exits as soon as it runs.
+*/
+int QuickExit(char* strArgs)
+{
+    k_exit(0);
+
+    return 0;
+}
+
+/* Times the ready-list walk over count PCBs of each layout: take the
+   head, run it as a dispatch does and move on to the next. */
+static void CompareLayouts(char* testName, int count, int counter)
+{
+    Process* pProcs;
+    LegacyProcess* pLegacy = calloc(count, sizeof(LegacyProcess));
+    int* pOrder = malloc(count * sizeof(int));
+    Process* pProc;
+    LegacyProcess* pOld;
+    unsigned int startTime, elapsed[2];
+    long long misses[2];
+    int iterations = count * BENCH_ROUNDS;
+
+#ifdef _MSC_VER
+    pProcs = _aligned_malloc(count * sizeof(Process), 64);
+#else
+    pProcs = aligned_alloc(64, count * sizeof(Process));
+#endif
+    if (count == 0 || pProcs == NULL || pLegacy == NULL || pOrder == NULL)
+    {
+        FreeAligned(pProcs);
+        free(pLegacy);
+        free(pOrder);
+        return;
+    }
+    memset(pProcs, 0, count * sizeof(Process));
+
+    ShuffleOrder(pOrder, count);
+    for (int i = 0; i < count; ++i)
+    {
+        pProc = &pProcs[pOrder[i]];
+        pProc->nextReadyProcess = (ProcessIndex)(pOrder[(i + 1) % count] + 1);
+        pProc->priority = LOWEST_PRIORITY + 1;
+        pProc->status = STATUS_READY;
+        pOld = &pLegacy[pOrder[i]];
+        pOld->nextReadyProcess = &pLegacy[pOrder[(i + 1) % count]];
+        pOld->priority = LOWEST_PRIORITY + 1;
+        pOld->status = STATUS_READY;
+    }
+
+    misses[0] = ReadCounter(counter);
+    startTime = system_clock();
+    pProc = &pProcs[pOrder[0]];
+    for (int i = 0; i < iterations; ++i)
+    {
+        pProc->status = STATUS_RUNNING;
+        pProc->cpuTime += pProc->priority;
+        pProc->sliceStart = (DWORD)i;
+        pProc->status = STATUS_READY;
+        pProc = &pProcs[pProc->nextReadyProcess - 1];
+    }
+    elapsed[0] = system_clock() - startTime;
+    misses[0] = ReadCounter(counter) - misses[0];
+
+    misses[1] = ReadCounter(counter);
+    startTime = system_clock();
+    pOld = &pLegacy[pOrder[0]];
+    for (int i = 0; i < iterations; ++i)
+    {
+        pOld->status = STATUS_RUNNING;
+        pOld->cpuTime += pOld->priority;
+        pOld->sliceStart = (DWORD)i;
+        pOld->status = STATUS_READY;
+        pOld = pOld->nextReadyProcess;
+    }
+    elapsed[1] = system_clock() - startTime;
+    misses[1] = ReadCounter(counter) - misses[1];
+
+    console_output(FALSE, "%s: same walk, %d-byte PCB %8.1f ns, %d-byte PCB %8.1f ns per dispatch\n",
+        testName, (int)sizeof(Process), elapsed[0] * 1000.0 / iterations,
+        (int)sizeof(LegacyProcess), elapsed[1] * 1000.0 / iterations);
+    if (counter >= 0)
+    {
+        console_output(FALSE, "%s: same walk, %8.2f and %8.2f cache misses per dispatch\n", testName,
+            (double)misses[0] / iterations, (double)misses[1] / iterations);
+    }
+
+    FreeAligned(pProcs);
+    free(pLegacy);
+    free(pOrder);
+}
+
+static void FreeAligned(void* pMemory)
+{
+#ifdef _MSC_VER
+    _aligned_free(pMemory);
+#else
+    free(pMemory);
+#endif
+}
+
+/* Fills pOrder with a fixed pseudo-random permutation of 0..count-1, so
+   the walk does not run through memory in order. */
+static void ShuffleOrder(int* pOrder, int count)
+{
+    unsigned int seed = 12345;
+    int j, swap;
+
+    for (int i = 0; i < count; ++i)
+    {
+        pOrder[i] = i;
+    }
+    for (int i = count - 1; i > 0; --i)
+    {
+        seed = seed * 1103515245u + 12345u;
+        j = (int)((seed >> 8) % (unsigned int)(i + 1));
+        swap = pOrder[i];
+        pOrder[i] = pOrder[j];
+        pOrder[j] = swap;
+    }
+}
+
+/* Opens a counter of the hardware cache misses of this process, or
+   returns -1. */
+static int OpenCacheMissCounter(void)
+{
+#ifdef __linux__
+    struct perf_event_attr attr;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = PERF_COUNT_HW_CACHE_MISSES;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+#else
+    return -1;
+#endif
+}
+
+static long long ReadCounter(int fd)
+{
+    long long value = 0;
+
+#ifdef __linux__
+    if (fd >= 0 && read(fd, &value, sizeof(value)) != sizeof(value))
+    {
+        value = 0;
+    }
+#endif
+    return value;
+}
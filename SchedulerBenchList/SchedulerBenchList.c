@@ -0,0 +1,204 @@
+#include <stdio.h>
+#include "THREADSLib.h"
+#include "SchedulerTesting.h"
+#include "Scheduler.h"
+#include "../Processes.h"
+#include "../ProcessTable.h"
+#include "../ProcessList.h"
+
+#define BENCH_OPERATIONS 1000000
+
+/* The ready list as it was written for the one field, with pointers to
+   the first and last process. */
+typedef struct
+{
+    Process* pHead;
+    Process* pTail;
+} PointerList;
+
+static void BenchLists(char* testName, int processCount);
+static void PointerListAdd(PointerList* pList, Process* pProc);
+static Process* PointerListPop(PointerList* pList);
+static void PointerListRemove(PointerList* pList, Process* pProc);
+static unsigned int NextRandom(unsigned int* pSeed);
+
+/*********************************************************************************
+*
+* SchedulerBenchList
+*
+* Measures the ready list from ProcessList.h (an INDEX_DLIST) against the
+* hand-written singly linked ready list it replaced, with 100 and 10,000
+* processes on the list:
+*   - round robin: pop the first process and push it back on the end, as the
+*     dispatcher does with a ready list;
+*   - remove and append: take a process out of the middle and put it back on
+*     the end, as a priority change does with a ready process.  The singly
+*     linked list has to walk to the process first.
+*
+* The lists link processes by table index, so the records are taken straight
+* from the process table (with its limit raised) without spawning them.
+*
+*********************************************************************************/
+int SchedulerEntryPoint(void* pArgs)
+{
+    char* testName = "SchedulerBenchList";
+
+    console_output(FALSE, "\n%s: started\n", testName);
+
+    BenchLists(testName, 100);
+    BenchLists(testName, 10000);
+
+    k_exit(0);
+
+    return 0;
+}
+
+static void BenchLists(char* testName, int processCount)
+{
+    Process** pProcs;
+    Process* pProc;
+    PointerList pointerList = { NULL, NULL };
+    ProcessIndex readyQueue = 0;
+    unsigned int seed;
+    unsigned int startTime, pointerTime, queueTime, pointerRemoveTime, queueRemoveTime;
+    int pointerRemoves = processCount > 1000 ? BENCH_OPERATIONS / 100 : BENCH_OPERATIONS;
+
+    set_process_limit(processCount + MAXPROC);
+    pProcs = calloc(processCount, sizeof(Process*));
+    if (pProcs == NULL)
+    {
+        console_output(FALSE, "%s: out of memory\n", testName);
+        stop(1);
+    }
+
+    for (int i = 0; i < processCount; ++i)
+    {
+        pProcs[i] = ProcessTableAllocate();
+        if (pProcs[i] == NULL)
+        {
+            console_output(FALSE, "%s: process table full\n", testName);
+            stop(1);
+        }
+        PointerListAdd(&pointerList, pProcs[i]);
+    }
+
+    startTime = system_clock();
+    for (int i = 0; i < BENCH_OPERATIONS; ++i)
+    {
+        PointerListAdd(&pointerList, PointerListPop(&pointerList));
+    }
+    pointerTime = system_clock() - startTime;
+
+    /* Remove a process from anywhere in the list and append it again.
+       Both lists see the same pseudo-random sequence. */
+    seed = 1;
+    startTime = system_clock();
+    for (int i = 0; i < pointerRemoves; ++i)
+    {
+        pProc = pProcs[NextRandom(&seed) % processCount];
+        PointerListRemove(&pointerList, pProc);
+        PointerListAdd(&pointerList, pProc);
+    }
+    pointerRemoveTime = system_clock() - startTime;
+
+    while (PointerListPop(&pointerList) != NULL)
+        ;
+    for (int i = 0; i < processCount; ++i)
+    {
+        ReadyQueueAppend(&readyQueue, pProcs[i]->index);
+    }
+    startTime = system_clock();
+    for (int i = 0; i < BENCH_OPERATIONS; ++i)
+    {
+        ReadyQueueAppend(&readyQueue, ReadyQueuePop(&readyQueue));
+    }
+    queueTime = system_clock() - startTime;
+
+    seed = 1;
+    startTime = system_clock();
+    for (int i = 0; i < BENCH_OPERATIONS; ++i)
+    {
+        pProc = pProcs[NextRandom(&seed) % processCount];
+        ReadyQueueRemove(&readyQueue, pProc->index);
+        ReadyQueueAppend(&readyQueue, pProc->index);
+    }
+    queueRemoveTime = system_clock() - startTime;
+
+    console_output(FALSE, "%s: %5d processes: round robin, pointer list %6.1f ns, ReadyQueue %6.1f ns\n",
+        testName, processCount, pointerTime * 1000.0 / BENCH_OPERATIONS, queueTime * 1000.0 / BENCH_OPERATIONS);
+    console_output(FALSE, "%s: %5d processes: remove+append, pointer list %8.1f ns, ReadyQueue %6.1f ns\n",
+        testName, processCount, pointerRemoveTime * 1000.0 / pointerRemoves, queueRemoveTime * 1000.0 / BENCH_OPERATIONS);
+
+    for (int i = 0; i < processCount; ++i)
+    {
+        ProcessTableRelease(pProcs[i]);
+    }
+    free(pProcs);
+}
+
+static void PointerListAdd(PointerList* pList, Process* pProc)
+{
+    pProc->nextReadyProcess = 0;
+    if (pList->pHead == NULL)
+    {
+        pList->pHead = pList->pTail = pProc;
+    }
+    else
+    {
+        pList->pTail->nextReadyProcess = pProc->index;
+        pList->pTail = pProc;
+    }
+}
+
+static Process* PointerListPop(PointerList* pList)
+{
+    Process* pNode = pList->pHead;
+
+    if (pNode != NULL)
+    {
+        pList->pHead = ProcessLink(pNode, nextReadyProcess);
+        if (pList->pHead == NULL)
+        {
+            pList->pTail = NULL;
+        }
+        pNode->nextReadyProcess = 0;
+    }
+    return pNode;
+}
+
+/* The walk a singly linked list needs to take a process out of the middle. */
+static void PointerListRemove(PointerList* pList, Process* pProc)
+{
+    Process* pPrev = NULL;
+    Process* pNode = pList->pHead;
+
+    while (pNode != NULL && pNode != pProc)
+    {
+        pPrev = pNode;
+        pNode = ProcessLink(pNode, nextReadyProcess);
+    }
+    if (pNode == NULL)
+    {
+        return;
+    }
+    if (pPrev == NULL)
+    {
+        pList->pHead = ProcessLink(pProc, nextReadyProcess);
+    }
+    else
+    {
+        pPrev->nextReadyProcess = pProc->nextReadyProcess;
+    }
+    if (pList->pTail == pProc)
+    {
+        pList->pTail = pPrev;
+    }
+    pProc->nextReadyProcess = 0;
+}
+
+/* A small LCG, so the removal order does not settle into the list order. */
+static unsigned int NextRandom(unsigned int* pSeed)
+{
+    *pSeed = *pSeed * 1103515245u + 12345u;
+    return *pSeed >> 16;
+}
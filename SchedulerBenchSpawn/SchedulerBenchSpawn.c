@@ -0,0 +1,136 @@
+#include <stdio.h>
+#include "THREADSLib.h"
+#include "SchedulerTesting.h"
+#include "Scheduler.h"
+#include "../Processes.h"
+
+#define BENCH_ITERATIONS 1000000
+
+/* watchdog, this process, the churner and one worker */
+#define FILLERS (MAXPROC - 4)
+
+int Filler(char* strArgs);
+int Churner(char* strArgs);
+int Worker(char* strArgs);
+
+/*********************************************************************************
+*
+* SchedulerBenchSpawn
+*
+* Measures spawn/exit throughput with the process table full.  Idle children
+* take every slot except the churner's and one more.  The churner spawns a
+* worker into that last free slot, waits for it to exit and repeats, so
+* every k_spawn searches a full table.  A spawn while the worker is alive
+* must fail with -1.  The cost of the old linear search for a free slot at
+* the same occupancy is shown for comparison.  Each worker's stack comes
+* from the runtime's stack pool; with THREADSLinux, trimming the pool at the
+* end shows how much it was holding.
+*
+*********************************************************************************/
+int SchedulerEntryPoint(void* pArgs)
+{
+    char* testName = "SchedulerBenchSpawn";
+    char nameBuffer[512];
+    int status = -1, kidpid;
+
+    console_output(FALSE, "\n%s: started, %d process slots\n", testName, MAXPROC);
+
+    for (int i = 0; i < FILLERS; ++i)
+    {
+        snprintf(nameBuffer, sizeof(nameBuffer), "%s-Filler%d", testName, i + 1);
+        kidpid = k_spawn(nameBuffer, Filler, nameBuffer, THREADS_MIN_STACK_SIZE, LOWEST_PRIORITY + 1);
+    }
+
+    snprintf(nameBuffer, sizeof(nameBuffer), "%s-Churner", testName);
+    kidpid = k_spawn(nameBuffer, Churner, nameBuffer, THREADS_MIN_STACK_SIZE, HIGHEST_PRIORITY - 1);
+    k_join(kidpid, &status);
+
+    for (int i = 0; i < FILLERS; ++i)
+    {
+        k_wait(&status);
+    }
+#ifdef __linux__
+    console_output(FALSE, "%s: stack pool trim released %u bytes\n", testName, context_pool_trim());
+#endif
+    console_output(FALSE, "%s: done\n", testName);
+
+    k_exit(0);
+
+    return 0;
+}
+
+/*
+*  Filler - holds a process slot until the parent waits for it.
+*/
+int Filler(char* strArgs)
+{
+    k_exit(0);
+
+    return 0;
+}
+
+/*
+*  Churner - spawns and reaps workers in the last free slot.
+*/
+int Churner(char* strArgs)
+{
+    int status = -1, extra;
+    unsigned int startTime, spawnTime, scanTime;
+    volatile int sink = 0;
+    static int slotStatus[MAXPROC];
+
+    k_spawn("Worker", Worker, NULL, THREADS_MIN_STACK_SIZE, LOWEST_PRIORITY + 2);
+    extra = k_spawn("Extra", Worker, NULL, THREADS_MIN_STACK_SIZE, LOWEST_PRIORITY + 2);
+    console_output(FALSE, "%s: spawn with the table full returned %d\n", strArgs, extra);
+    k_wait(&status);
+
+    startTime = system_clock();
+    for (int i = 0; i < BENCH_ITERATIONS; ++i)
+    {
+        k_spawn("Worker", Worker, NULL, THREADS_MIN_STACK_SIZE, LOWEST_PRIORITY + 2);
+        k_wait(&status);
+    }
+    spawnTime = system_clock() - startTime;
+
+    /* The search k_spawn used to do, from the next pid's slot round to
+       the one free slot, over a table with the same occupancy. */
+    for (int i = 0; i < MAXPROC - 1; ++i)
+    {
+        slotStatus[i] = STATUS_READY;
+    }
+    startTime = system_clock();
+    for (int i = 0; i < BENCH_ITERATIONS; ++i)
+    {
+        int slot = i % MAXPROC;
+        int steps = 0;
+
+        while (slotStatus[slot] != STATUS_EMPTY && steps < MAXPROC)
+        {
+            slot = (slot + 1) % MAXPROC;
+            steps++;
+        }
+        sink += slot;
+    }
+    scanTime = system_clock() - startTime;
+
+    console_output(FALSE, "%s: spawn+exit+wait  %8.2f us\n", strArgs,
+        (double)spawnTime / BENCH_ITERATIONS);
+    console_output(FALSE, "%s: spawns per second %8.0f\n", strArgs,
+        BENCH_ITERATIONS * 1000000.0 / spawnTime);
+    console_output(FALSE, "%s: linear slot scan  %8.1f ns\n", strArgs,
+        scanTime * 1000.0 / BENCH_ITERATIONS);
+
+    k_exit(0);
+
+    return 0;
+}
+
+/*
+*  Worker - exits at once.
+*/
+int Worker(char* strArgs)
+{
+    k_exit(1);
+
+    return 0;
+}
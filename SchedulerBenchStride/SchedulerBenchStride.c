@@ -0,0 +1,108 @@
+#include <stdio.h>
+#include "THREADSLib.h"
+#include "SchedulerTesting.h"
+#include "Scheduler.h"
+
+#define CHILD_COUNT 4
+#define CHILD_PRIORITY 3
+#define SLICE_MS 80
+
+static int tickets[CHILD_COUNT] = { 100, 200, 300, 400 };
+static int durations[] = { 500, 1000, 2000, 4000 };
+static int cpuTime[CHILD_COUNT];
+static DWORD runEnd;
+
+static int CpuHog(void* pArgs);
+
+/*********************************************************************************
+*
+* SchedulerBenchStride
+*
+* Measures how closely the stride policy divides the CPU by tickets.  Four
+* CPU-bound children with 100, 200, 300 and 400 tickets run until a common
+* deadline and record their CPU time.  For each run length the benchmark
+* prints each child's share and the largest difference, in percentage points,
+* from its ticket share.  Stride scheduling bounds the error by about one time
+* slice, so the printed bound is the slice as a share of the run length.
+*
+*********************************************************************************/
+int SchedulerEntryPoint(void* pArgs)
+{
+    char* testName = "SchedulerBenchStride";
+    char nameBuffer[512];
+    char argBuffer[16];
+    int status = -1;
+    int totalTickets = 0, totalTime;
+    double share, error, maxError;
+
+    console_output(FALSE, "\n%s: started\n", testName);
+
+    if (set_scheduler_policy("stride") < 0)
+    {
+        console_output(FALSE, "%s: no stride policy\n", testName);
+        k_exit(1);
+    }
+    set_time_slice(CHILD_PRIORITY, SLICE_MS);
+
+    for (int i = 0; i < CHILD_COUNT; ++i)
+    {
+        totalTickets += tickets[i];
+    }
+
+    for (int run = 0; run < (int)(sizeof(durations) / sizeof(durations[0])); ++run)
+    {
+        runEnd = system_clock() + durations[run] * 1000;
+        for (int i = 0; i < CHILD_COUNT; ++i)
+        {
+            snprintf(nameBuffer, sizeof(nameBuffer), "%s-Child%d", testName, i + 1);
+            snprintf(argBuffer, sizeof(argBuffer), "%d", i);
+            k_spawn_tickets(nameBuffer, CpuHog, argBuffer, THREADS_MIN_STACK_SIZE, CHILD_PRIORITY, tickets[i]);
+        }
+        for (int i = 0; i < CHILD_COUNT; ++i)
+        {
+            k_wait(&status);
+        }
+
+        totalTime = 0;
+        for (int i = 0; i < CHILD_COUNT; ++i)
+        {
+            totalTime += cpuTime[i];
+        }
+
+        console_output(FALSE, "%s: %5d ms: shares", testName, durations[run]);
+        maxError = 0;
+        for (int i = 0; i < CHILD_COUNT; ++i)
+        {
+            share = 100.0 * cpuTime[i] / totalTime;
+            error = share - 100.0 * tickets[i] / totalTickets;
+            if (error < 0)
+            {
+                error = -error;
+            }
+            if (error > maxError)
+            {
+                maxError = error;
+            }
+            console_output(FALSE, " %5.1f%%", share);
+        }
+        console_output(FALSE, ", max error %4.2f points (bound %4.2f)\n", maxError,
+            100.0 * SLICE_MS / durations[run]);
+    }
+
+    k_exit(0);
+
+    return 0;
+}
+
+/* Spins until the deadline and records its own CPU time. */
+static int CpuHog(void* pArgs)
+{
+    int index = atoi((char*)pArgs);
+
+    while ((int)(runEnd - system_clock()) > 0)
+    {
+    }
+    cpuTime[index] = read_time();
+
+    return 0;
+}
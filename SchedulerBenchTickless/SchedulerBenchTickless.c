@@ -0,0 +1,98 @@
+#include <stdio.h>
+#include "THREADSLib.h"
+#include "SchedulerTesting.h"
+#include "Scheduler.h"
+
+#define RUN_MS 1000
+
+static DWORD runEnd;
+
+static void RunScenario(char* testName, char* scenario, int hogs, int realtime);
+static int CpuHog(void* pArgs);
+static int ControlLoop(void* pArgs);
+
+/*********************************************************************************
+*
+* SchedulerBenchTickless
+*
+* Counts clock interrupts per second with the periodic tick and in tickless
+* mode for three loads: a single runnable process, two processes sharing a
+* priority, and a single process next to a real-time task with a 100 ms
+* period.  Tickless mode should take no interrupts for the first, one per
+* time slice for the second and one per period for the third.
+*
+*********************************************************************************/
+int SchedulerEntryPoint(void* pArgs)
+{
+    char* testName = "SchedulerBenchTickless";
+
+    console_output(FALSE, "\n%s: started\n", testName);
+
+    for (int tickless = 0; tickless <= 1; ++tickless)
+    {
+        if (set_tickless(tickless) < 0)
+        {
+            console_output(FALSE, "%s: clock has no one-shot mode\n", testName);
+            break;
+        }
+        console_output(FALSE, "%s: %s\n", testName, tickless ? "tickless" : "periodic tick");
+        RunScenario(testName, "1 runnable", 1, FALSE);
+        RunScenario(testName, "2 runnable", 2, FALSE);
+        RunScenario(testName, "1 runnable + real-time", 1, TRUE);
+    }
+
+    k_exit(0);
+
+    return 0;
+}
+
+static void RunScenario(char* testName, char* scenario, int hogs, int realtime)
+{
+    char nameBuffer[512];
+    int status;
+    unsigned int interrupts;
+    DWORD startTime;
+
+    startTime = system_clock();
+    interrupts = read_interrupt_count();
+    runEnd = startTime + RUN_MS * 1000;
+
+    for (int i = 0; i < hogs; ++i)
+    {
+        snprintf(nameBuffer, sizeof(nameBuffer), "%s-Hog%d", testName, i + 1);
+        k_spawn(nameBuffer, CpuHog, NULL, THREADS_MIN_STACK_SIZE, 3);
+    }
+    if (realtime)
+    {
+        snprintf(nameBuffer, sizeof(nameBuffer), "%s-Control", testName);
+        k_spawn_rt(nameBuffer, ControlLoop, NULL, THREADS_MIN_STACK_SIZE, 2, 100, 100);
+    }
+    for (int i = 0; i < hogs + (realtime ? 1 : 0); ++i)
+    {
+        k_wait(&status);
+    }
+
+    interrupts = read_interrupt_count() - interrupts;
+    console_output(FALSE, "%s:   %-24s %6.1f interrupts/s\n", testName, scenario,
+        interrupts * 1000000.0 / (system_clock() - startTime));
+}
+
+/* Spins until the end of the run. */
+static int CpuHog(void* pArgs)
+{
+    while ((int)(runEnd - system_clock()) > 0)
+    {
+    }
+    return 0;
+}
+
+/* A 2 ms job every period until the end of the run. */
+static int ControlLoop(void* pArgs)
+{
+    while ((int)(runEnd - system_clock()) > 0)
+    {
+        SystemDelay(2);
+        k_wait_next_period();
+    }
+    return 0;
+}
@@ -0,0 +1,280 @@
+#include "THREADSLib.h"
+#include "Scheduler.h"
+#include "Processes.h"
+#include "ProcessHeap.h"
+#include "SchedulerPolicy.h"
+#include "ProcessTable.h"
+
+/* Earliest deadline first real-time class.  Processes created with
+   k_spawn_rt sit above every scheduling policy: a ready real-time process
+   always preempts a policy process, and among themselves the one with the
+   earliest absolute deadline runs.  Each job is released at the start of
+   its period and finishes when the process calls k_wait_next_period.
+   A job that uses up its runtime before that is throttled: it waits for
+   the next release like a finished job and carries on as the next job,
+   so an overrunning task cannot take more than the share it reserved.
+   Releases and budgets are checked on the clock tick, so they are up to
+   one tick late.
+
+   Ready processes are in edfHeap by absolute deadline, and processes
+   waiting for a release are in releaseHeap by release time, so the next
+   release is found in O(1) and released in O(log n).  Both heaps are
+   keyed on raw read_clock() times, so ordering is only exact within one
+   wrap (about 71 minutes) of the 32-bit clock. */
+#define EDF_UTILIZATION_MAX     1000000     /* 1.0 in parts per million */
+static ProcessHeap edfHeap;
+static ProcessHeap releaseHeap;             /* STATUS_BLOCKED_PERIOD, by rtNextRelease */
+static int edfUtilization;                  /* admitted total, parts per million */
+
+static int EdfShare(int runtime, int deadline, int period);
+static void EdfStartJob(Process* pProc);
+static void EdfWaitForRelease(Process* pProc);
+
+/* ---------------------------------------------------------------
+    EdfInitialize
+
+    Purpose - Empties the real-time class
+--------------------------------------------------------------- */
+void EdfInitialize(void)
+{
+    ProcessHeapInitialize(&edfHeap);
+    ProcessHeapInitialize(&releaseHeap);
+    edfUtilization = 0;
+}
+
+/* ---------------------------------------------------------------
+    EdfReserve
+
+    Purpose - Admission control.  Reserves runtime / min(deadline,
+                period) of the CPU if the total stays at or below 1.0.
+    Parameters - runtime, deadline and period in microseconds
+    Returns - TRUE if the task was admitted
+--------------------------------------------------------------- */
+int EdfReserve(int runtime, int deadline, int period)
+{
+    int share = EdfShare(runtime, deadline, period);
+
+    if (edfUtilization + share > EDF_UTILIZATION_MAX)
+    {
+        return FALSE;
+    }
+    edfUtilization += share;
+    return TRUE;
+}
+
+/* ---------------------------------------------------------------
+    EdfAttach
+
+    Purpose - Makes a new process real-time with its first job
+                released now.  The CPU share must already be reserved.
+    Parameters - the process, runtime, deadline and period (us), now
+--------------------------------------------------------------- */
+void EdfAttach(Process* pProc, int runtime, int deadline, int period, DWORD now)
+{
+    ProcessCold* pCold = ProcessColdOf(pProc);
+
+    pCold->rtRuntime = runtime;
+    pCold->rtDeadline = deadline;
+    pCold->deadlineMisses = 0;
+    pProc->rtPeriod = period;
+    pProc->rtNextRelease = now;
+    EdfStartJob(pProc);
+}
+
+/* ---------------------------------------------------------------
+    EdfDetach
+
+    Purpose - Removes an exiting real-time process and returns its
+                CPU share
+    Parameters - the process, which must be running, so it is in
+                neither heap
+--------------------------------------------------------------- */
+void EdfDetach(Process* pProc)
+{
+    ProcessCold* pCold = ProcessColdOf(pProc);
+
+    edfUtilization -= EdfShare(pCold->rtRuntime, pCold->rtDeadline, pProc->rtPeriod);
+    pProc->rtPeriod = 0;
+}
+
+/* ---------------------------------------------------------------
+    EdfEnqueue
+
+    Purpose - Queues a ready real-time process by absolute deadline
+--------------------------------------------------------------- */
+void EdfEnqueue(Process* pProc)
+{
+    pProc->sortKey = pProc->rtAbsDeadline;
+    ProcessHeapInsert(&edfHeap, pProc);
+}
+
+/* ---------------------------------------------------------------
+    EdfPreempts
+
+    Purpose - Checks whether a queued real-time process should take
+                the CPU from the running process
+    Returns - TRUE if the earliest queued deadline beats pRunning
+--------------------------------------------------------------- */
+int EdfPreempts(Process* pRunning)
+{
+    Process* pFirst = ProcessHeapPeek(&edfHeap);
+
+    if (pFirst == NULL)
+    {
+        return FALSE;
+    }
+    if (pRunning == NULL || pRunning->status != STATUS_RUNNING || pRunning->rtPeriod == 0)
+    {
+        return TRUE;
+    }
+    return (int)(pFirst->rtAbsDeadline - pRunning->rtAbsDeadline) < 0;
+}
+
+/* ---------------------------------------------------------------
+    EdfPickNext
+
+    Purpose - Pops the real-time process with the earliest deadline
+                if it should displace pRunning
+    Returns - the process to run, or NULL
+--------------------------------------------------------------- */
+Process* EdfPickNext(Process* pRunning)
+{
+    if (!EdfPreempts(pRunning))
+    {
+        return NULL;
+    }
+    return ProcessHeapPop(&edfHeap);
+}
+
+/* ---------------------------------------------------------------
+    EdfReleaseJobs
+
+    Purpose - Clock tick.  Queues every real-time process that is
+                waiting for a period that has now started.
+    Parameters - now
+    Returns - the number of processes queued
+--------------------------------------------------------------- */
+int EdfReleaseJobs(DWORD now)
+{
+    Process* pProc;
+    int released = 0;
+
+    while ((pProc = ProcessHeapPeek(&releaseHeap)) != NULL &&
+           (int)(now - pProc->rtNextRelease) >= 0)
+    {
+        ProcessHeapPop(&releaseHeap);
+        EdfStartJob(pProc);
+        pProc->status = STATUS_READY;
+        EdfEnqueue(pProc);
+        released++;
+    }
+    return released;
+}
+
+/* ---------------------------------------------------------------
+    EdfNextRelease
+
+    Purpose - Finds the earliest release among the real-time
+                processes waiting for their next period
+    Parameters - DWORD *pRelease - receives the release time
+    Returns - TRUE if any process is waiting
+--------------------------------------------------------------- */
+int EdfNextRelease(DWORD* pRelease)
+{
+    Process* pProc = ProcessHeapPeek(&releaseHeap);
+
+    if (pProc == NULL)
+    {
+        return FALSE;
+    }
+    *pRelease = pProc->rtNextRelease;
+    return TRUE;
+}
+
+/* ---------------------------------------------------------------
+    EdfCompleteJob
+
+    Purpose - Ends the current job of a real-time process, counting
+                a miss if it finished after its deadline.  An overrun
+                past the next release starts the next job at once;
+                otherwise the process is queued for its release and
+                the caller blocks it.
+    Parameters - the process, now
+    Returns - TRUE if the next job has already been released
+--------------------------------------------------------------- */
+int EdfCompleteJob(Process* pProc, DWORD now)
+{
+    if ((int)(now - pProc->rtAbsDeadline) > 0)
+    {
+        ProcessColdOf(pProc)->deadlineMisses++;
+    }
+
+    if ((int)(now - pProc->rtNextRelease) >= 0)
+    {
+        EdfStartJob(pProc);
+        return TRUE;
+    }
+    EdfWaitForRelease(pProc);
+    return FALSE;
+}
+
+/* ---------------------------------------------------------------
+    EdfCharge
+
+    Purpose - Takes CPU time the process has used off the budget of
+                its current job
+    Parameters - the process, microseconds
+--------------------------------------------------------------- */
+void EdfCharge(Process* pProc, int microseconds)
+{
+    pProc->rtBudget -= microseconds;
+}
+
+/* ---------------------------------------------------------------
+    EdfThrottle
+
+    Purpose - Clock tick for a running real-time process.  A job
+                that has used up its runtime is throttled until the
+                next release and counts as a deadline miss, as the
+                deadline is no later than that release.
+    Parameters - the running process, now
+    Returns - TRUE if the process was throttled; it is then
+                STATUS_BLOCKED_PERIOD and must be switched out
+--------------------------------------------------------------- */
+int EdfThrottle(Process* pProc, DWORD now)
+{
+    if ((int)(now - pProc->sliceStart) < pProc->rtBudget)
+    {
+        return FALSE;
+    }
+
+    ProcessColdOf(pProc)->deadlineMisses++;
+    pProc->status = STATUS_BLOCKED_PERIOD;
+    EdfWaitForRelease(pProc);
+    return TRUE;
+}
+
+/* Releases the job of the period starting at rtNextRelease, with a
+   fresh budget. */
+static void EdfStartJob(Process* pProc)
+{
+    ProcessCold* pCold = ProcessColdOf(pProc);
+
+    pProc->rtAbsDeadline = pProc->rtNextRelease + pCold->rtDeadline;
+    pProc->rtNextRelease += pProc->rtPeriod;
+    pProc->rtBudget = pCold->rtRuntime;
+}
+
+static void EdfWaitForRelease(Process* pProc)
+{
+    pProc->sortKey = pProc->rtNextRelease;
+    ProcessHeapInsert(&releaseHeap, pProc);
+}
+
+/* CPU share of a task in parts per million. */
+static int EdfShare(int runtime, int deadline, int period)
+{
+    int window = deadline < period ? deadline : period;
+
+    return (int)((int64_t)runtime * EDF_UTILIZATION_MAX / window);
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+/* Scheduling policy operations.  The core (Scheduler.c) owns process state
+   and the context switch; the active policy owns the run queue and decides
+   which ready process runs next.
+
+	name        - matched against set_scheduler_policy() / SCHEDULER_POLICY
+	start       - the policy becomes active (optional)
+	stop        - the policy is being replaced; its queues are empty (optional)
+	enqueue     - add a ready process to the run queue
+	dequeue     - remove a ready process from the run queue, FALSE if not queued
+	pick_next   - remove and return the process to run next, or NULL to keep
+	              pRunning.  pRunning is NULL or not STATUS_RUNNING when the
+	              CPU is being given up.
+	tick        - clock tick for the running process, TRUE to preempt it
+	charge      - the process ran for the given microseconds (optional)
+	on_block    - the running process blocked, before its slice is charged;
+	              returns the priority it should have, which the core sets
+	              with ChangePriority() so that what it waits on inherits
+	              the change (optional)
+	on_wake     - a new or blocked process is about to be enqueued (optional)
+*/
+typedef struct _scheduler_policy
+{
+	const char* name;
+	void     (*start)(void);
+	void     (*stop)(void);
+	void     (*enqueue)(Process* pProc);
+	int      (*dequeue)(Process* pProc);
+	Process* (*pick_next)(Process* pRunning);
+	int      (*tick)(Process* pRunning, DWORD now);
+	void     (*charge)(Process* pProc, int microseconds);
+	int      (*on_block)(Process* pProc, DWORD now);
+	void     (*on_wake)(Process* pProc);
+} SchedulerPolicy;
+
+extern const SchedulerPolicy PriorityPolicy;   /* fixed priority, the default */
+extern const SchedulerPolicy MlfqPolicy;       /* multi-level feedback */
+extern const SchedulerPolicy CfsPolicy;        /* weighted virtual runtime */
+extern const SchedulerPolicy StridePolicy;     /* proportional share by tickets */
+
+/* Scheduler.c */
+extern const SchedulerPolicy* schedulerPolicy;
+extern int timeSlice[];
+extern int booting;
+void SchedulerSetPolicy(const SchedulerPolicy* pPolicy);
+void ChargeSlice(Process* pProc, DWORD now);
+
+/* SchedulerPolicyPriority.c - the per-priority ready lists, also used by
+   the other policies for the watchdog at LOWEST_PRIORITY. */
+extern List readyList[];
+extern unsigned int readyBitmap;
+void     ListInitialize(List* pList);
+void     ListAddNode(List* pList, Process* pProcToAdd);
+Process* ListPopNode(List* pList);
+int      ListRemoveNode(List* pList, Process* pProcToRemove);
+void     PriorityEnqueue(Process* pProc);
+int      PriorityDequeue(Process* pProc);
+Process* PriorityPickNext(Process* pRunning);
+
+/* TRUE once the running process has used the time slice for its priority. */
+static inline int SliceExpired(Process* pProc, DWORD now)
+{
+	return (int)(now - pProc->sliceStart) >= timeSlice[pProc->priority] * 1000;
+}
+
+/* SchedulerEdf.c - the earliest deadline first class above the policies. */
+void     EdfInitialize(void);
+int      EdfReserve(int runtime, int deadline, int period);
+void     EdfAttach(Process* pProc, int runtime, int deadline, int period, DWORD now);
+void     EdfDetach(Process* pProc);
+void     EdfEnqueue(Process* pProc);
+int      EdfPreempts(Process* pRunning);
+Process* EdfPickNext(Process* pRunning);
+int      EdfReleaseJobs(DWORD now);
+int      EdfNextRelease(DWORD* pRelease);
+int      EdfCompleteJob(Process* pProc, DWORD now);
+void     EdfCharge(Process* pProc, int microseconds);
+int      EdfThrottle(Process* pProc, DWORD now);
@@ -0,0 +1,123 @@
+#include "THREADSLib.h"
+#include "Scheduler.h"
+#include "Processes.h"
+#include "ProcessHeap.h"
+#include "SchedulerPolicy.h"
+#include "SchedulerPolicyHeap.h"
+
+/* Fair scheduling.  Processes above LOWEST_PRIORITY wait in cfsQueue
+   ordered by weighted virtual runtime instead of in readyList[], and the
+   k_spawn priority only sets the weight (x1.25 per level).  The process
+   that has had the least weighted CPU always runs next.  The watchdog
+   stays in readyList[LOWEST_PRIORITY] and only runs when the heap is empty. */
+#define CFS_NICE_0_WEIGHT       1024
+#define CFS_WAKEUP_CREDIT       20000   /* max vruntime lead of a waking process (us) */
+static int cfsWeight[HIGHEST_PRIORITY + 1];
+
+static void CfsStart(void);
+static void CfsEnqueue(Process* pProc);
+static int CfsDequeue(Process* pProc);
+static Process* CfsPickNext(Process* pRunning);
+static int CfsTick(Process* pRunning, DWORD now);
+static void CfsCharge(Process* pProc, int microseconds);
+static uint64_t CfsAdvance(Process* pProc, int microseconds);
+static void CfsOnWake(Process* pProc);
+
+static HeapPolicy cfsQueue = { { NULL, 0 }, 0, CfsAdvance };
+
+const SchedulerPolicy CfsPolicy =
+{
+    "cfs",
+    CfsStart,
+    NULL,
+    CfsEnqueue,
+    CfsDequeue,
+    CfsPickNext,
+    CfsTick,
+    CfsCharge,
+    NULL,
+    CfsOnWake
+};
+
+/**************************************************************************
+   Name - set_cfs
+
+   Purpose - Turns fair scheduling on or off.  Turning it off returns to
+             fixed priority scheduling.
+
+   Parameters - enabled
+
+   Returns - the previous setting
+
+*************************************************************************/
+int set_cfs(int enabled)
+{
+    int previous = schedulerPolicy == &CfsPolicy;
+
+    if (enabled)
+    {
+        SchedulerSetPolicy(&CfsPolicy);
+    }
+    else if (previous)
+    {
+        SchedulerSetPolicy(&PriorityPolicy);
+    }
+
+    return previous;
+}
+
+/* Weights, CFS_NICE_0_WEIGHT at the middle priority. */
+static void CfsStart(void)
+{
+    HeapPolicyStart(&cfsQueue);
+    cfsWeight[(HIGHEST_PRIORITY + 1) / 2] = CFS_NICE_0_WEIGHT;
+    for (int i = (HIGHEST_PRIORITY + 1) / 2 + 1; i <= HIGHEST_PRIORITY; ++i)
+    {
+        cfsWeight[i] = cfsWeight[i - 1] * 5 / 4;
+    }
+    for (int i = (HIGHEST_PRIORITY + 1) / 2 - 1; i >= LOWEST_PRIORITY; --i)
+    {
+        cfsWeight[i] = cfsWeight[i + 1] * 4 / 5 > 0 ? cfsWeight[i + 1] * 4 / 5 : 1;
+    }
+}
+
+static void CfsEnqueue(Process* pProc)
+{
+    HeapPolicyEnqueue(&cfsQueue, pProc);
+}
+
+static int CfsDequeue(Process* pProc)
+{
+    return HeapPolicyDequeue(&cfsQueue, pProc);
+}
+
+static Process* CfsPickNext(Process* pRunning)
+{
+    return HeapPolicyPickNext(&cfsQueue, pRunning);
+}
+
+static int CfsTick(Process* pRunning, DWORD now)
+{
+    return HeapPolicyTick(&cfsQueue, pRunning, now);
+}
+
+static uint64_t CfsAdvance(Process* pProc, int microseconds)
+{
+    pProc->vruntime += (uint64_t)microseconds * CFS_NICE_0_WEIGHT / cfsWeight[pProc->priority];
+    return pProc->vruntime;
+}
+
+static void CfsCharge(Process* pProc, int microseconds)
+{
+    CfsAdvance(pProc, microseconds);
+}
+
+/* A process that slept is placed at most one credit ahead of the others
+   rather than with all of its saved-up runtime. */
+static void CfsOnWake(Process* pProc)
+{
+    if (pProc->vruntime + CFS_WAKEUP_CREDIT < cfsQueue.lastKey)
+    {
+        pProc->vruntime = cfsQueue.lastKey - CFS_WAKEUP_CREDIT;
+    }
+}
@@ -0,0 +1,79 @@
+#include "THREADSLib.h"
+#include "Scheduler.h"
+#include "Processes.h"
+#include "ProcessHeap.h"
+#include "SchedulerPolicy.h"
+#include "SchedulerPolicyHeap.h"
+
+void HeapPolicyStart(HeapPolicy* pPolicy)
+{
+    ProcessHeapInitialize(&pPolicy->heap);
+}
+
+void HeapPolicyEnqueue(HeapPolicy* pPolicy, Process* pProc)
+{
+    if (pProc->priority == LOWEST_PRIORITY)
+    {
+        PriorityEnqueue(pProc);
+        return;
+    }
+    pProc->sortKey = pPolicy->advance(pProc, 0);
+    ProcessHeapInsert(&pPolicy->heap, pProc);
+}
+
+int HeapPolicyDequeue(HeapPolicy* pPolicy, Process* pProc)
+{
+    if (pProc->priority == LOWEST_PRIORITY)
+    {
+        return PriorityDequeue(pProc);
+    }
+    ProcessHeapRemove(&pPolicy->heap, pProc);
+    return TRUE;
+}
+
+/**************************************************************************
+   Name - HeapPolicyPickNext
+
+   Purpose - Pops the process with the smallest key.  Heap processes only
+             preempt the watchdog; a running heap process gives up the CPU
+             in HeapPolicyTick().
+
+   Returns - the process to run next, or NULL to keep the current one
+
+*************************************************************************/
+Process* HeapPolicyPickNext(HeapPolicy* pPolicy, Process* pRunning)
+{
+    Process* nextProcess;
+
+    if (ProcessHeapPeek(&pPolicy->heap) == NULL)
+    {
+        return PriorityPickNext(pRunning);
+    }
+
+    if (pRunning != NULL && pRunning->status == STATUS_RUNNING &&
+        pRunning->priority != LOWEST_PRIORITY)
+    {
+        return NULL;
+    }
+
+    nextProcess = ProcessHeapPop(&pPolicy->heap);
+    if (nextProcess->sortKey > pPolicy->lastKey)
+    {
+        pPolicy->lastKey = nextProcess->sortKey;
+    }
+    return nextProcess;
+}
+
+/* Yield once the slice is up and a waiting process has a smaller key. */
+int HeapPolicyTick(HeapPolicy* pPolicy, Process* pRunning, DWORD now)
+{
+    if (!SliceExpired(pRunning, now))
+    {
+        return FALSE;
+    }
+
+    ChargeSlice(pRunning, now);
+    return pRunning->priority != LOWEST_PRIORITY &&
+        ProcessHeapPeek(&pPolicy->heap) != NULL &&
+        ProcessHeapPeek(&pPolicy->heap)->sortKey < pPolicy->advance(pRunning, 0);
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+/* The run queue shared by the fair and stride policies.  Processes above
+   LOWEST_PRIORITY wait in a ProcessHeap ordered by a per-process key that
+   only grows as the process runs; the watchdog stays in
+   readyList[LOWEST_PRIORITY] and runs only when the heap is empty.  A
+   running process is preempted at the end of its slice if a waiting one
+   has a smaller key.  Needs Processes.h and ProcessHeap.h first.
+
+	advance   - the key-update callback: charges pProc for the given
+	            microseconds of CPU and returns its key.  Called with 0 to
+	            read the key.
+	lastKey   - key of the most recently dispatched process, which a policy
+	            can use to place a waking process */
+typedef struct _heap_policy
+{
+	ProcessHeap heap;
+	uint64_t lastKey;
+	uint64_t (*advance)(Process* pProc, int microseconds);
+} HeapPolicy;
+
+void     HeapPolicyStart(HeapPolicy* pPolicy);
+void     HeapPolicyEnqueue(HeapPolicy* pPolicy, Process* pProc);
+int      HeapPolicyDequeue(HeapPolicy* pPolicy, Process* pProc);
+Process* HeapPolicyPickNext(HeapPolicy* pPolicy, Process* pRunning);
+int      HeapPolicyTick(HeapPolicy* pPolicy, Process* pRunning, DWORD now);
@@ -0,0 +1,191 @@
+#include "THREADSLib.h"
+#include "Scheduler.h"
+#include "Processes.h"
+#include "SchedulerPolicy.h"
+#include "ProcessTable.h"
+#include "ProcessList.h"
+
+/* Multi-level feedback.  A process that uses a whole slice drops one
+   level, one that blocks rises one level (never above its k_spawn
+   priority), and every boost interval all processes go back to their
+   k_spawn priority.  Level LOWEST_PRIORITY stays reserved for the watchdog.
+   The ready lists are the fixed priority ones.  A boost only walks the
+   ready lists; a process that was blocked through a boost is reset when
+   it wakes, found by its last slice having started before the boost. */
+#define DEFAULT_MLFQ_BOOST_MS   1000
+static int mlfqBoostInterval = DEFAULT_MLFQ_BOOST_MS * 1000;   /* microseconds */
+static DWORD mlfqLastBoost;
+
+static void MlfqStart(void);
+static void MlfqStop(void);
+static int MlfqTick(Process* pRunning, DWORD now);
+static int MlfqOnBlock(Process* pProc, DWORD now);
+static void MlfqOnWake(Process* pProc);
+static void MlfqBoost(Process* pRunning);
+static void MlfqReset(Process* pProc);
+
+const SchedulerPolicy MlfqPolicy =
+{
+    "mlfq",
+    MlfqStart,
+    MlfqStop,
+    PriorityEnqueue,
+    PriorityDequeue,
+    PriorityPickNext,
+    MlfqTick,
+    NULL,
+    MlfqOnBlock,
+    MlfqOnWake
+};
+
+/**************************************************************************
+   Name - set_mlfq
+
+   Purpose - Turns multi-level feedback scheduling on or off.  Turning it
+             off returns to fixed priority scheduling with every process
+             back at its k_spawn priority.
+
+   Parameters - enabled, boost interval in milliseconds (<= 0 for default)
+
+   Returns - the previous setting
+
+*************************************************************************/
+int set_mlfq(int enabled, int boostMilliseconds)
+{
+    int previous = schedulerPolicy == &MlfqPolicy;
+
+    if (boostMilliseconds <= 0)
+    {
+        boostMilliseconds = DEFAULT_MLFQ_BOOST_MS;
+    }
+    mlfqBoostInterval = boostMilliseconds * 1000;
+
+    if (enabled)
+    {
+        SchedulerSetPolicy(&MlfqPolicy);
+    }
+    else if (previous)
+    {
+        SchedulerSetPolicy(&PriorityPolicy);
+    }
+
+    return previous;
+}
+
+static void MlfqStart(void)
+{
+    mlfqLastBoost = read_clock();
+}
+
+/* Leave every process at its k_spawn priority (or the priority it
+   inherits, if higher) for the next policy, which will not reset a
+   blocked process when it wakes.  Only runs on a policy change. */
+static void MlfqStop(void)
+{
+    for (Process* pProc = ProcessTableNext(NULL); pProc != NULL; pProc = ProcessTableNext(pProc))
+    {
+        MlfqReset(pProc);
+    }
+}
+
+/**************************************************************************
+   Name - MlfqTick
+
+   Purpose - Boosts everyone once the boost interval has passed, then
+             sinks a process that used its whole slice by one level before
+             the usual round robin check.
+
+   Returns - TRUE to preempt the running process
+
+*************************************************************************/
+static int MlfqTick(Process* pRunning, DWORD now)
+{
+    if ((int)(now - mlfqLastBoost) >= mlfqBoostInterval)
+    {
+        MlfqBoost(pRunning);
+        mlfqLastBoost = now;
+    }
+
+    if (!SliceExpired(pRunning, now))
+    {
+        return FALSE;
+    }
+
+    /* Used the whole slice: sink one level, but not below an inherited
+       priority. */
+    if (pRunning->priority > LOWEST_PRIORITY + 1 && pRunning->priority > pRunning->inheritedPriority)
+    {
+        pRunning->priority--;
+    }
+
+    if ((readyBitmap & ~((1u << pRunning->priority) - 1)) != 0)
+    {
+        return TRUE;
+    }
+
+    ChargeSlice(pRunning, now);
+    return FALSE;
+}
+
+/* Blocking before the slice ran out: rise one level.  The core applies
+   the new priority, so the process it waits on inherits it. */
+static int MlfqOnBlock(Process* pProc, DWORD now)
+{
+    if (!SliceExpired(pProc, now) && pProc->priority < pProc->basePriority)
+    {
+        return pProc->priority + 1;
+    }
+    return pProc->priority;
+}
+
+/* A process blocked since before the last boost missed it. */
+static void MlfqOnWake(Process* pProc)
+{
+    if ((int)(mlfqLastBoost - pProc->sliceStart) > 0)
+    {
+        MlfqReset(pProc);
+    }
+}
+
+static void MlfqReset(Process* pProc)
+{
+    pProc->priority = pProc->inheritedPriority > pProc->basePriority ?
+        pProc->inheritedPriority : pProc->basePriority;
+}
+
+/**************************************************************************
+   Name - MlfqBoost
+
+   Purpose - Resets the running and every ready process to its k_spawn
+             priority and rebuilds the ready lists to match, keeping FIFO
+             order within a level.  Blocked processes are reset by
+             MlfqOnWake.
+
+*************************************************************************/
+static void MlfqBoost(Process* pRunning)
+{
+    Process* pProc;
+    Process* pNext;
+    Process* heads[HIGHEST_PRIORITY + 1];
+
+    MlfqReset(pRunning);
+
+    /* Detach every list first so a process is never added to the list
+       that is being walked. */
+    for (int i = HIGHEST_PRIORITY; i >= LOWEST_PRIORITY; --i)
+    {
+        heads[i] = ProcessFromIndex(ReadyQueueTake(&readyList[i].head));
+        readyList[i].count = 0;
+    }
+    readyBitmap = 0;
+
+    for (int i = HIGHEST_PRIORITY; i >= LOWEST_PRIORITY; --i)
+    {
+        for (pProc = heads[i]; pProc != NULL; pProc = pNext)
+        {
+            pNext = ProcessLink(pProc, nextReadyProcess);
+            MlfqReset(pProc);
+            ListAddNode(&readyList[pProc->priority], pProc);
+        }
+    }
+}
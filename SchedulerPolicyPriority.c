@@ -0,0 +1,206 @@
+#include "THREADSLib.h"
+#include "Scheduler.h"
+#include "Processes.h"
+#include "SchedulerPolicy.h"
+#include "ProcessTable.h"
+#include "ProcessList.h"
+
+List readyList[HIGHEST_PRIORITY + 1]; // One list per priority
+
+/* Bit n is set while readyList[n] is non-empty.  Maintained by ListAddNode
+   and ListPopNode so PriorityPickNext never has to walk the lists. */
+unsigned int readyBitmap;
+#if HIGHEST_PRIORITY > 31
+#error HIGHEST_PRIORITY must fit in the ready bitmap
+#endif
+
+static inline int HighestSetBit(unsigned int mask);
+static int PriorityTick(Process* pRunning, DWORD now);
+
+/* Fixed priority: highest priority first, round robin within a level. */
+const SchedulerPolicy PriorityPolicy =
+{
+    "priority",
+    NULL,
+    NULL,
+    PriorityEnqueue,
+    PriorityDequeue,
+    PriorityPickNext,
+    PriorityTick,
+    NULL,
+    NULL,
+    NULL
+};
+
+/* ---------------------------------------------------------------
+    ListInitialize
+
+    Purpose - Initialize a List type
+    Parameters - nextPrevOffset - offset from beginning of
+                structure to the next and previous pointers
+                with the structure that makes up the nodes
+    Returns - None
+    Side Effects -
+--------------------------------------------------------------- */
+void ListInitialize(List* pList)
+{
+    pList->head = 0;
+    pList->count = 0;
+    pList->priorityBit = 0;
+}
+
+/* ---------------------------------------------------------------
+    ListAddNode
+
+    Purpose - Adds a node to the end of the list
+    Parameters - List *pList - pointer to the list
+                Process *pProcToAdd - the node to add
+    Returns - None
+    Side Effects - sets the list's bit in readyBitmap
+--------------------------------------------------------------- */
+void ListAddNode(List* pList, Process* pProcToAdd)
+{
+    ReadyQueueAppend(&pList->head, pProcToAdd->index);
+    readyBitmap |= pList->priorityBit;
+    pList->count++;
+}
+
+/* ---------------------------------------------------------------
+    ListPopNode
+
+    Purpose - Removes the first node from the list and returns
+                a pointer to it
+    Parameters - List *pList - pointer to the list
+    Returns - A pointer to the removed node, or NULL if empty
+    Side Effects - clears the list's bit in readyBitmap once empty
+--------------------------------------------------------------- */
+Process* ListPopNode(List* pList)
+{
+    Process* pNode = ProcessFromIndex(ReadyQueuePop(&pList->head));
+
+    if (pNode != NULL && --pList->count == 0)
+    {
+        readyBitmap &= ~pList->priorityBit;
+    }
+    return pNode;
+}
+
+/* ---------------------------------------------------------------
+    ListRemoveNode
+
+    Purpose - Removes a node from anywhere in the list
+    Parameters - List *pList - pointer to the list
+                Process *pProcToRemove - the node to remove
+    Returns - TRUE if the node was found and removed.  A node on a
+                list always has a prev link, so this takes constant time.
+    Side Effects - clears the list's bit in readyBitmap once empty
+--------------------------------------------------------------- */
+int ListRemoveNode(List* pList, Process* pProcToRemove)
+{
+    if (pProcToRemove->prevReadyProcess == 0)
+    {
+        return FALSE;
+    }
+    ReadyQueueRemove(&pList->head, pProcToRemove->index);
+    if (--pList->count == 0)
+    {
+        readyBitmap &= ~pList->priorityBit;
+    }
+    return TRUE;
+}
+
+/**************************************************************************
+   Name - PriorityEnqueue
+
+   Purpose - Appends the process to the tail of the ready list for its
+             priority.
+
+*************************************************************************/
+void PriorityEnqueue(Process* pProc)
+{
+    ListAddNode(&readyList[pProc->priority], pProc);
+}
+
+/**************************************************************************
+   Name - PriorityDequeue
+
+   Purpose - Takes a ready process off the ready list for its priority.
+
+   Returns - TRUE if the process was on the list
+
+*************************************************************************/
+int PriorityDequeue(Process* pProc)
+{
+    return ListRemoveNode(&readyList[pProc->priority], pProc);
+}
+
+/**************************************************************************
+   Name - PriorityPickNext
+
+   Purpose - Pops the highest priority ready process.  A process that is
+             still running is only displaced by a strictly higher priority.
+             The priority comes from readyBitmap in a single bit scan, so
+             the cost does not depend on the number of priority levels.
+
+   Parameters - the running process, if any
+
+   Returns - the process to run next, or NULL to keep the current one
+
+*************************************************************************/
+Process* PriorityPickNext(Process* pRunning)
+{
+    unsigned int candidates = readyBitmap;
+    Process* nextProcess = NULL;
+
+    if (pRunning != NULL && pRunning->status == STATUS_RUNNING)
+    {
+        /* Mask off the running priority and everything below it. */
+        candidates &= ~((2u << pRunning->priority) - 1);
+    }
+
+    if (candidates != 0)
+    {
+        nextProcess = ListPopNode(&readyList[HighestSetBit(candidates)]);
+    }
+
+    return nextProcess;
+}
+
+/* Index of the most significant set bit.  mask must be non-zero. */
+static inline int HighestSetBit(unsigned int mask)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanReverse(&index, mask);
+    return (int)index;
+#else
+    return 31 - __builtin_clz(mask);
+#endif
+}
+
+/**************************************************************************
+   Name - PriorityTick
+
+   Purpose - Round robin within a priority level.  Once the running
+             process has used up the time slice for its priority it is
+             preempted, provided another process at that priority or
+             higher is waiting; otherwise it simply starts a new slice.
+
+   Returns - TRUE to preempt the running process
+
+*************************************************************************/
+static int PriorityTick(Process* pRunning, DWORD now)
+{
+    if (!SliceExpired(pRunning, now))
+    {
+        return FALSE;
+    }
+
+    if ((readyBitmap & ~((1u << pRunning->priority) - 1)) != 0)
+    {
+        return TRUE;
+    }
+
+    ChargeSlice(pRunning, now);
+    return FALSE;
+}
@@ -0,0 +1,85 @@
+#include "THREADSLib.h"
+#include "Scheduler.h"
+#include "Processes.h"
+#include "ProcessHeap.h"
+#include "SchedulerPolicy.h"
+#include "SchedulerPolicyHeap.h"
+
+/* Stride scheduling.  Each process holds tickets and a pass value; running
+   for t microseconds advances pass by t * STRIDE1 / tickets, and the
+   process with the smallest pass runs next, so CPU time converges to the
+   ticket ratio with an error bounded by one slice per process.  Processes
+   above LOWEST_PRIORITY wait in strideQueue keyed on pass; the k_spawn
+   priority is not used.  The watchdog stays in readyList[LOWEST_PRIORITY]. */
+#define STRIDE1                 (1 << 20)
+
+static void StrideStart(void);
+static void StrideEnqueue(Process* pProc);
+static int StrideDequeue(Process* pProc);
+static Process* StridePickNext(Process* pRunning);
+static int StrideTick(Process* pRunning, DWORD now);
+static void StrideCharge(Process* pProc, int microseconds);
+static uint64_t StrideAdvance(Process* pProc, int microseconds);
+static void StrideOnWake(Process* pProc);
+
+static HeapPolicy strideQueue = { { NULL, 0 }, 0, StrideAdvance };
+
+const SchedulerPolicy StridePolicy =
+{
+    "stride",
+    StrideStart,
+    NULL,
+    StrideEnqueue,
+    StrideDequeue,
+    StridePickNext,
+    StrideTick,
+    StrideCharge,
+    NULL,
+    StrideOnWake
+};
+
+static void StrideStart(void)
+{
+    HeapPolicyStart(&strideQueue);
+}
+
+static void StrideEnqueue(Process* pProc)
+{
+    HeapPolicyEnqueue(&strideQueue, pProc);
+}
+
+static int StrideDequeue(Process* pProc)
+{
+    return HeapPolicyDequeue(&strideQueue, pProc);
+}
+
+static Process* StridePickNext(Process* pRunning)
+{
+    return HeapPolicyPickNext(&strideQueue, pRunning);
+}
+
+static int StrideTick(Process* pRunning, DWORD now)
+{
+    return HeapPolicyTick(&strideQueue, pRunning, now);
+}
+
+static uint64_t StrideAdvance(Process* pProc, int microseconds)
+{
+    pProc->pass += (uint64_t)microseconds * STRIDE1 / pProc->tickets;
+    return pProc->pass;
+}
+
+static void StrideCharge(Process* pProc, int microseconds)
+{
+    StrideAdvance(pProc, microseconds);
+}
+
+/* A new or woken process joins at the current pass rather than with the
+   credit it would otherwise have built up while it was not runnable. */
+static void StrideOnWake(Process* pProc)
+{
+    if (pProc->pass < strideQueue.lastKey)
+    {
+        pProc->pass = strideQueue.lastKey;
+    }
+}
@@ -0,0 +1,87 @@
+#include <stdio.h>
+#include "THREADSLib.h"
+#include "SchedulerTesting.h"
+#include "Scheduler.h"
+
+#define INTERACTIVE_ROUNDS 5
+
+int CpuHog(char* strArgs);
+int Interactive(char* strArgs);
+
+/*********************************************************************************
+*
+* SchedulerTest32
+*
+* Multi-level feedback scheduling.  Spawns a busy priority 4 process and a
+* priority 3 process that repeatedly spawns a short child and waits for it.
+* With set_mlfq() enabled the busy process sinks below priority 3 after its
+* first time slices, so the interactive rounds finish while the busy process
+* is still running instead of after it.
+*
+*********************************************************************************/
+int SchedulerEntryPoint(void* pArgs)
+{
+    char* testName = "SchedulerTest32";
+    int status = -1, kidpid = -1;
+    char nameBuffer[512];
+
+    console_output(FALSE, "\n%s: started\n", testName);
+    set_mlfq(TRUE, 0);
+
+    snprintf(nameBuffer, sizeof(nameBuffer), "%s-Child1", testName);
+    kidpid = k_spawn(nameBuffer, CpuHog, nameBuffer, THREADS_MIN_STACK_SIZE, 4);
+    console_output(FALSE, "%s: after spawn of child with pid %d\n", testName, kidpid);
+
+    snprintf(nameBuffer, sizeof(nameBuffer), "%s-Child2", testName);
+    kidpid = k_spawn(nameBuffer, Interactive, nameBuffer, THREADS_MIN_STACK_SIZE, 3);
+    console_output(FALSE, "%s: after spawn of child with pid %d\n", testName, kidpid);
+
+    for (int i = 0; i < 2; ++i)
+    {
+        kidpid = k_wait(&status);
+        console_output(FALSE, "%s: exit status for child %d is %d\n", testName, kidpid, status);
+    }
+
+    k_exit(0);
+
+    return 0;
+}
+
+/*
+*  CpuHog - busy waits for two seconds.
+*/
+int CpuHog(char* strArgs)
+{
+    console_output(FALSE, "%s: started\n", strArgs);
+    SystemDelay(2000);
+    console_output(FALSE, "%s: quitting\n", strArgs);
+
+    k_exit(-4);
+
+    return 0;
+}
+
+/*
+*  Interactive - short bursts separated by waits on a child.
+*/
+int Interactive(char* strArgs)
+{
+    int status;
+    unsigned int startTime = read_clock() / 1000;
+    char nameBuffer[512];
+
+    console_output(FALSE, "%s: started\n", strArgs);
+    for (int i = 0; i < INTERACTIVE_ROUNDS; ++i)
+    {
+        snprintf(nameBuffer, sizeof(nameBuffer), "%s-Child%d", strArgs, i + 1);
+        k_spawn(nameBuffer, SimpleDelayExit, nameBuffer, THREADS_MIN_STACK_SIZE, 3);
+        k_wait(&status);
+        console_output(FALSE, "%s: round %d done after %u ms\n", strArgs, i + 1,
+            read_clock() / 1000 - startTime);
+    }
+    console_output(FALSE, "%s: quitting\n", strArgs);
+
+    k_exit(-5);
+
+    return 0;
+}
@@ -0,0 +1,94 @@
+#include <stdio.h>
+#include "THREADSLib.h"
+#include "SchedulerTesting.h"
+#include "Scheduler.h"
+
+#define CONTROL_JOBS 10
+
+int CpuHog(char* strArgs);
+int ControlLoop(char* strArgs);
+
+/*********************************************************************************
+*
+* SchedulerTest33
+*
+* Earliest deadline first real-time class.  A priority 5 process keeps the CPU
+* busy while two control loops spawned with k_spawn_rt run 5 ms jobs every 50
+* and 100 ms.  Both should report no deadline misses even though the busy
+* process would hold the CPU for 80 ms slices under fixed priorities.  A third
+* real-time spawn that would take utilisation above 1.0 must be rejected with
+* -2, and one with a budget longer than its deadline with -1.
+*
+*********************************************************************************/
+int SchedulerEntryPoint(void* pArgs)
+{
+    char* testName = "SchedulerTest33";
+    int status = -1, kidpid = -1;
+    char nameBuffer[512];
+
+    console_output(FALSE, "\n%s: started\n", testName);
+
+    snprintf(nameBuffer, sizeof(nameBuffer), "%s-Child1", testName);
+    kidpid = k_spawn(nameBuffer, CpuHog, nameBuffer, THREADS_MIN_STACK_SIZE, 5);
+    console_output(FALSE, "%s: after spawn of child with pid %d\n", testName, kidpid);
+
+    snprintf(nameBuffer, sizeof(nameBuffer), "%s-Control1", testName);
+    kidpid = k_spawn_rt(nameBuffer, ControlLoop, nameBuffer, THREADS_MIN_STACK_SIZE, 10, 50, 50);
+    console_output(FALSE, "%s: after spawn of real-time child with pid %d\n", testName, kidpid);
+
+    snprintf(nameBuffer, sizeof(nameBuffer), "%s-Control2", testName);
+    kidpid = k_spawn_rt(nameBuffer, ControlLoop, nameBuffer, THREADS_MIN_STACK_SIZE, 20, 100, 100);
+    console_output(FALSE, "%s: after spawn of real-time child with pid %d\n", testName, kidpid);
+
+    snprintf(nameBuffer, sizeof(nameBuffer), "%s-Control3", testName);
+    kidpid = k_spawn_rt(nameBuffer, ControlLoop, nameBuffer, THREADS_MIN_STACK_SIZE, 70, 100, 100);
+    console_output(FALSE, "%s: spawn above utilisation 1.0 returned %d\n", testName, kidpid);
+
+    kidpid = k_spawn_rt(nameBuffer, ControlLoop, nameBuffer, THREADS_MIN_STACK_SIZE, 20, 10, 100);
+    console_output(FALSE, "%s: spawn with runtime > deadline returned %d\n", testName, kidpid);
+
+    for (int i = 0; i < 3; ++i)
+    {
+        kidpid = k_wait(&status);
+        console_output(FALSE, "%s: exit status for child %d is %d\n", testName, kidpid, status);
+    }
+
+    k_exit(0);
+
+    return 0;
+}
+
+/*
+*  CpuHog - busy waits for two seconds.
+*/
+int CpuHog(char* strArgs)
+{
+    console_output(FALSE, "%s: started\n", strArgs);
+    SystemDelay(2000);
+    console_output(FALSE, "%s: quitting\n", strArgs);
+
+    k_exit(-4);
+
+    return 0;
+}
+
+/*
+*  ControlLoop - a 5 ms job once per period.
+*/
+int ControlLoop(char* strArgs)
+{
+    int misses;
+
+    console_output(FALSE, "%s: started\n", strArgs);
+    for (int i = 0; i < CONTROL_JOBS; ++i)
+    {
+        SystemDelay(5);
+        k_wait_next_period();
+    }
+    misses = get_deadline_misses(k_getpid());
+    console_output(FALSE, "%s: %d jobs, %d deadline misses\n", strArgs, CONTROL_JOBS, misses);
+
+    k_exit(misses);
+
+    return 0;
+}
@@ -0,0 +1,103 @@
+#include <stdio.h>
+#include "THREADSLib.h"
+#include "SchedulerTesting.h"
+#include "Scheduler.h"
+
+int CpuHog(char* strArgs);
+int ShortJob(char* strArgs);
+int Joiner(char* strArgs);
+int pidToJoin;
+
+/*********************************************************************************
+*
+* SchedulerTest34
+*
+* Priority inheritance.  A priority 4 process joins a priority 1 process that
+* needs 50 ms of CPU while a priority 3 process busy waits for two seconds.
+* The joined process inherits priority 4 (and then 5, from the parent joining
+* the priority 4 process), so it finishes before the priority 3 process and
+* the join returns in well under a second instead of after the busy wait.
+*
+*********************************************************************************/
+int SchedulerEntryPoint(void* pArgs)
+{
+    char* testName = "SchedulerTest34";
+    int status = -1, kidpid = -1, joinerPid;
+    char nameBuffer[512];
+
+    console_output(FALSE, "\n%s: started\n", testName);
+
+    snprintf(nameBuffer, sizeof(nameBuffer), "%s-Hog", testName);
+    kidpid = k_spawn(nameBuffer, CpuHog, nameBuffer, THREADS_MIN_STACK_SIZE, 3);
+    console_output(FALSE, "%s: after spawn of child with pid %d\n", testName, kidpid);
+
+    snprintf(nameBuffer, sizeof(nameBuffer), "%s-Short", testName);
+    pidToJoin = k_spawn(nameBuffer, ShortJob, nameBuffer, THREADS_MIN_STACK_SIZE, 1);
+    console_output(FALSE, "%s: after spawn of child with pid %d\n", testName, pidToJoin);
+
+    snprintf(nameBuffer, sizeof(nameBuffer), "%s-Joiner", testName);
+    joinerPid = k_spawn(nameBuffer, Joiner, nameBuffer, THREADS_MIN_STACK_SIZE, 4);
+    console_output(FALSE, "%s: after spawn of child with pid %d\n", testName, joinerPid);
+
+    kidpid = k_join(joinerPid, &status);
+    console_output(FALSE, "%s: join of %d returned %d, exit status %d\n", testName, joinerPid, kidpid, status);
+
+    for (int i = 0; i < 3; ++i)
+    {
+        kidpid = k_wait(&status);
+        console_output(FALSE, "%s: exit status for child %d is %d\n", testName, kidpid, status);
+    }
+
+    k_exit(0);
+
+    return 0;
+}
+
+/*
+*  CpuHog - busy waits for two seconds.
+*/
+int CpuHog(char* strArgs)
+{
+    console_output(FALSE, "%s: started\n", strArgs);
+    SystemDelay(2000);
+    console_output(FALSE, "%s: quitting\n", strArgs);
+
+    k_exit(-3);
+
+    return 0;
+}
+
+/*
+*  ShortJob - busy waits for 50 ms.
+*/
+int ShortJob(char* strArgs)
+{
+    console_output(FALSE, "%s: started\n", strArgs);
+    SystemDelay(50);
+    console_output(FALSE, "%s: quitting\n", strArgs);
+
+    k_exit(-1);
+
+    return 0;
+}
+
+/*
+*  Joiner - joins the short job and reports how long the join took.
+*/
+int Joiner(char* strArgs)
+{
+    int status = 0, result;
+    DWORD start;
+    int elapsed;
+
+    console_output(FALSE, "%s: started\n", strArgs);
+    start = read_clock();
+    result = k_join(pidToJoin, &status);
+    elapsed = (int)(read_clock() - start) / 1000;
+    console_output(FALSE, "%s: join of %d returned %d, exit status %d\n", strArgs, pidToJoin, result, status);
+    console_output(FALSE, "%s: join %s within 500 ms\n", strArgs, elapsed < 500 ? "completed" : "did NOT complete");
+
+    k_exit(-4);
+
+    return 0;
+}
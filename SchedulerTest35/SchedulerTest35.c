@@ -0,0 +1,88 @@
+#include <stdio.h>
+#include "THREADSLib.h"
+#include "SchedulerTesting.h"
+#include "Scheduler.h"
+
+#define CHILDREN 2000
+
+int QuickExit(char* strArgs);
+
+/*********************************************************************************
+*
+* SchedulerTest35
+*
+* Growable process table.  Raises the process limit and spawns 2000 children,
+* far beyond MAXPROC, then reaps them all.  The table should grow to hold them
+* and shrink back afterwards.  A pid that has been reaped must be rejected by
+* k_join even after its slot has been reused, and the limit cannot be lowered
+* below a live process.
+*
+*********************************************************************************/
+int SchedulerEntryPoint(void* pArgs)
+{
+    char* testName = "SchedulerTest35";
+    int status = -1, kidpid = -1, firstPid = -1, result;
+    int spawned = 0, reaped = 0;
+    char nameBuffer[512];
+
+    console_output(FALSE, "\n%s: started, capacity %d\n", testName, read_process_capacity());
+
+    result = set_process_limit(CHILDREN + 2);
+    console_output(FALSE, "%s: set_process_limit returned %d\n", testName, result);
+
+    for (int i = 0; i < CHILDREN; ++i)
+    {
+        snprintf(nameBuffer, sizeof(nameBuffer), "%s-Child%d", testName, i + 1);
+        kidpid = k_spawn(nameBuffer, QuickExit, nameBuffer, THREADS_MIN_STACK_SIZE, 1);
+        if (kidpid > 0)
+        {
+            spawned++;
+        }
+        if (i == 0)
+        {
+            firstPid = kidpid;
+        }
+    }
+    console_output(FALSE, "%s: spawned %d children, capacity %d\n", testName, spawned, read_process_capacity());
+
+    kidpid = k_spawn("OneTooMany", QuickExit, NULL, THREADS_MIN_STACK_SIZE, 1);
+    console_output(FALSE, "%s: spawn beyond the limit returned %d\n", testName, kidpid);
+
+    result = set_process_limit(MAXPROC);
+    console_output(FALSE, "%s: lowering the limit below live processes returned %d\n", testName, result);
+
+    for (int i = 0; i < spawned; ++i)
+    {
+        if (k_wait(&status) > 0)
+        {
+            reaped++;
+        }
+    }
+    console_output(FALSE, "%s: reaped %d children, capacity %d\n", testName, reaped, read_process_capacity());
+
+    /* The first child's slot is free again, so the next spawn takes it. */
+    kidpid = k_spawn("Reuse", QuickExit, NULL, THREADS_MIN_STACK_SIZE, 1);
+    console_output(FALSE, "%s: first child pid %d, pid in its slot now %d\n", testName,
+        firstPid, kidpid);
+    console_output(FALSE, "%s: k_join of the reaped pid returned %d\n", testName,
+        k_join(firstPid, &status));
+    k_wait(&status);
+
+    result = set_process_limit(MAXPROC);
+    console_output(FALSE, "%s: set_process_limit(MAXPROC) returned %d, capacity %d\n", testName,
+        result, read_process_capacity());
+
+    k_exit(0);
+
+    return 0;
+}
+
+/*
+*  QuickExit - exits as soon as it runs.
+*/
+int QuickExit(char* strArgs)
+{
+    k_exit(0);
+
+    return 0;
+}
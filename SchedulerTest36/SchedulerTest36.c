@@ -0,0 +1,77 @@
+#include <stdio.h>
+#include <string.h>
+#include "THREADSLib.h"
+#include "SchedulerTesting.h"
+#include "Scheduler.h"
+
+#define LONG_ARG_LENGTH 1000
+
+int CheckArgs(char* strArgs);
+
+/*********************************************************************************
+*
+* SchedulerTest36
+*
+* Process strings.  Spawns a child whose start argument is 1000 characters,
+* longer than the old 256 byte buffer, and checks that it arrives intact.  Then
+* spawns three children in turn with the same name and argument, and a child
+* with no argument, which gets an empty string.
+*
+*********************************************************************************/
+int SchedulerEntryPoint(void* pArgs)
+{
+    char* testName = "SchedulerTest36";
+    char longArg[LONG_ARG_LENGTH + 1];
+    int status = -1, kidpid = -1;
+
+    console_output(FALSE, "\n%s: started\n", testName);
+
+    for (int i = 0; i < LONG_ARG_LENGTH; ++i)
+    {
+        longArg[i] = 'a' + i % 26;
+    }
+    longArg[LONG_ARG_LENGTH] = '\0';
+
+    kidpid = k_spawn("SchedulerTest36-Long", CheckArgs, longArg, THREADS_MIN_STACK_SIZE, 3);
+    console_output(FALSE, "%s: after spawn of child with pid %d\n", testName, kidpid);
+    kidpid = k_wait(&status);
+    console_output(FALSE, "%s: exit status for child %d is %d\n", testName, kidpid, status);
+
+    for (int i = 0; i < 3; ++i)
+    {
+        kidpid = k_spawn("SchedulerTest36-Same", CheckArgs, "shared", THREADS_MIN_STACK_SIZE, 3);
+        console_output(FALSE, "%s: after spawn of child with pid %d\n", testName, kidpid);
+        kidpid = k_wait(&status);
+        console_output(FALSE, "%s: exit status for child %d is %d\n", testName, kidpid, status);
+    }
+
+    kidpid = k_spawn("SchedulerTest36-None", CheckArgs, NULL, THREADS_MIN_STACK_SIZE, 3);
+    console_output(FALSE, "%s: after spawn of child with pid %d\n", testName, kidpid);
+    kidpid = k_wait(&status);
+    console_output(FALSE, "%s: exit status for child %d is %d\n", testName, kidpid, status);
+
+    k_exit(0);
+
+    return 0;
+}
+
+/*
+*  CheckArgs - exits with the length of its argument, or -1 if a long
+*  argument does not hold the pattern it was spawned with.
+*/
+int CheckArgs(char* strArgs)
+{
+    int length = (int)strlen(strArgs);
+
+    for (int i = 0; length > 26 && i < length; ++i)
+    {
+        if (strArgs[i] != 'a' + i % 26)
+        {
+            k_exit(-1);
+        }
+    }
+    console_output(FALSE, "Child: argument length %d\n", length);
+    k_exit(length);
+
+    return 0;
+}
@@ -0,0 +1,80 @@
+#include <stdio.h>
+#include <string.h>
+#include "THREADSLib.h"
+#include "SchedulerTesting.h"
+#include "Scheduler.h"
+
+#define DEEP_STACK_SIZE     (1024 * 1024)
+#define RECURSION_DEPTH     256     /* about 1 KB of stack per call */
+
+int Recurse(char* strArgs);
+int Idle(char* strArgs);
+static int RecurseDown(int depth);
+
+/*********************************************************************************
+*
+* SchedulerTest37
+*
+* Lazily committed stacks.  Spawns a child with a 1 MB stack that recurses
+* about 256 KB deep, and an idle child behind it, and shows the process table
+* from the bottom of the recursion.  Stack(KB) should be large for the recursing
+* child only; the idle child and the rest should show the few pages they have
+* touched.
+*
+*********************************************************************************/
+int SchedulerEntryPoint(void* pArgs)
+{
+    char* testName = "SchedulerTest37";
+    int status = -1, kidpid = -1;
+
+    console_output(FALSE, "\n%s: started\n", testName);
+
+    kidpid = k_spawn("SchedulerTest37-Deep", Recurse, "SchedulerTest37-Deep", DEEP_STACK_SIZE, 3);
+    console_output(FALSE, "%s: after spawn of child with pid %d\n", testName, kidpid);
+    kidpid = k_spawn("SchedulerTest37-Idle", Idle, "SchedulerTest37-Idle", THREADS_MIN_STACK_SIZE, 3);
+    console_output(FALSE, "%s: after spawn of child with pid %d\n", testName, kidpid);
+
+    kidpid = k_wait(&status);
+    console_output(FALSE, "%s: exit status for child %d is %d\n", testName, kidpid, status);
+    kidpid = k_wait(&status);
+    console_output(FALSE, "%s: exit status for child %d is %d\n", testName, kidpid, status);
+
+    k_exit(0);
+
+    return 0;
+}
+
+/*
+*  Recurse - recurses deeply, exits with the depth reached.
+*/
+int Recurse(char* strArgs)
+{
+    console_output(FALSE, "%s: started\n", strArgs);
+    k_exit(RecurseDown(RECURSION_DEPTH));
+
+    return 0;
+}
+
+/*
+*  Idle - exits once it gets to run.
+*/
+int Idle(char* strArgs)
+{
+    console_output(FALSE, "%s: started\n", strArgs);
+    k_exit(0);
+
+    return 0;
+}
+
+static int RecurseDown(int depth)
+{
+    volatile char frame[1024];
+
+    memset((char*)frame, depth, sizeof(frame));
+    if (depth == 0)
+    {
+        display_process_table();
+        return 0;
+    }
+    return RecurseDown(depth - 1) + 1 + (frame[0] - (char)depth);
+}
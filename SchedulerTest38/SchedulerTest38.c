@@ -0,0 +1,70 @@
+#include <stdio.h>
+#include <string.h>
+#include "THREADSLib.h"
+#include "SchedulerTesting.h"
+#include "Scheduler.h"
+
+int UseStack(char* strArgs);
+static int RecurseDown(int depth);
+
+/*********************************************************************************
+*
+* SchedulerTest38
+*
+* Stack high-water profiling.  Turns profiling on, then runs four children of
+* one entry point that recurse 8, 16, 32 and 64 KB deep and two more of a
+* second entry point, with every exit reported.  The summary printed when the
+* system stops should show one line per entry point, with a maximum a little
+* above 64 KB for the first and the average of the four below it.
+*
+*********************************************************************************/
+int SchedulerEntryPoint(void* pArgs)
+{
+    char* testName = "SchedulerTest38";
+    char nameBuffer[512];
+    int status = -1, kidpid = -1;
+
+    console_output(FALSE, "\n%s: started\n", testName);
+    console_output(FALSE, "%s: set_stack_profiling returned %d\n", testName, set_stack_profiling(2));
+
+    for (int i = 0; i < 4; ++i)
+    {
+        snprintf(nameBuffer, sizeof(nameBuffer), "%d", 8 << i);
+        kidpid = k_spawn("SchedulerTest38-Deep", UseStack, nameBuffer, 16 * THREADS_MIN_STACK_SIZE, 3);
+        kidpid = k_wait(&status);
+        console_output(FALSE, "%s: exit status for child %d is %d\n", testName, kidpid, status);
+    }
+    for (int i = 0; i < 2; ++i)
+    {
+        snprintf(nameBuffer, sizeof(nameBuffer), "%s-Child%d", testName, i + 1);
+        kidpid = k_spawn(nameBuffer, SimpleDelayExit, nameBuffer, THREADS_MIN_STACK_SIZE, 3);
+        kidpid = k_wait(&status);
+        console_output(FALSE, "%s: exit status for child %d is %d\n", testName, kidpid, status);
+    }
+
+    k_exit(0);
+
+    return 0;
+}
+
+/*
+*  UseStack - recurses the number of KB given in its argument.
+*/
+int UseStack(char* strArgs)
+{
+    k_exit(RecurseDown(atoi(strArgs)));
+
+    return 0;
+}
+
+static int RecurseDown(int depth)
+{
+    volatile char frame[1024];
+
+    memset((char*)frame, depth, sizeof(frame));
+    if (depth <= 1)
+    {
+        return 1;
+    }
+    return RecurseDown(depth - 1) + 1 + (frame[0] - (char)depth);
+}
@@ -0,0 +1,81 @@
+#include <stdio.h>
+#include "THREADSLib.h"
+#include "SchedulerTesting.h"
+#include "Scheduler.h"
+
+#define CHILDREN (4 * MAXPROC)
+
+int ExitWithArg(char* strArgs);
+
+/*********************************************************************************
+*
+* SchedulerTest39
+*
+* Exit records.  Runs four times MAXPROC children one after another without
+* reaping them, joining each so it has exited before the next is spawned.
+* Exited children leave the process table, so every spawn should succeed at
+* the default limit.  A join of an exited child that has not been reaped
+* should still return its exit code, and k_wait should then reap all of them
+* with their exit codes.
+*
+*********************************************************************************/
+int SchedulerEntryPoint(void* pArgs)
+{
+    char* testName = "SchedulerTest39";
+    char argBuffer[32];
+    int status = -1, kidpid = -1, firstPid = -1;
+    int spawned = 0, reaped = 0, codeSum = 0, expectedSum = 0;
+
+    console_output(FALSE, "\n%s: started\n", testName);
+
+    for (int i = 0; i < CHILDREN; ++i)
+    {
+        snprintf(argBuffer, sizeof(argBuffer), "%d", i + 1);
+        kidpid = k_spawn("SchedulerTest39-Child", ExitWithArg, argBuffer, THREADS_MIN_STACK_SIZE, 3);
+        if (kidpid < 0)
+        {
+            console_output(FALSE, "%s: spawn %d failed with %d\n", testName, i + 1, kidpid);
+            break;
+        }
+        if (i == 0)
+        {
+            firstPid = kidpid;
+        }
+        spawned++;
+        expectedSum += i + 1;
+        k_join(kidpid, &status);
+    }
+    console_output(FALSE, "%s: spawned %d children, capacity %d\n", testName, spawned, read_process_capacity());
+
+    status = -1;
+    console_output(FALSE, "%s: k_join of the first child returned %d\n", testName, k_join(firstPid, &status));
+    console_output(FALSE, "%s: its exit status is %d\n", testName, status);
+
+    for (int i = 0; i < spawned; ++i)
+    {
+        if (k_wait(&status) > 0)
+        {
+            reaped++;
+            codeSum += status;
+        }
+    }
+    console_output(FALSE, "%s: reaped %d children, exit codes %s\n", testName, reaped,
+        codeSum == expectedSum ? "match" : "DO NOT MATCH");
+
+    console_output(FALSE, "%s: k_join of the first child after reaping returned %d\n", testName,
+        k_join(firstPid, &status));
+
+    k_exit(0);
+
+    return 0;
+}
+
+/*
+*  ExitWithArg - exits with the number in its argument.
+*/
+int ExitWithArg(char* strArgs)
+{
+    k_exit(atoi(strArgs));
+
+    return 0;
+}
@@ -0,0 +1,101 @@
+#include <stdio.h>
+#include "THREADSLib.h"
+#include "SchedulerTesting.h"
+#include "Scheduler.h"
+
+#define CHILDREN 300
+
+int ExitWithArg(char* strArgs);
+
+/*********************************************************************************
+*
+* SchedulerTest40
+*
+* k_waitpid.  Spawns 300 low priority children, then:
+*   - polls with WAIT_NOHANG before any has run, which should return 0;
+*   - waits for the last child by pid, which blocks until it quits;
+*   - reaps the rest by pid in reverse order, polling each with
+*     WAIT_NOHANG first.  Under the priority policies none of them has
+*     quit yet, as waiting by pid only lends the parent's priority to the
+*     child waited for, so each is then waited for;
+*   - checks the error returns for a bad pid and for no children left.
+* Finally three more children are joined one by one, so they quit in spawn
+* order, and k_wait should reap them in that order.
+*
+*********************************************************************************/
+int SchedulerEntryPoint(void* pArgs)
+{
+    char* testName = "SchedulerTest40";
+    char argBuffer[32];
+    static int pids[CHILDREN];
+    int status = -1, kidpid = -1, matched = 0, running = 0;
+
+    console_output(FALSE, "\n%s: started\n", testName);
+    set_process_limit(CHILDREN + 2);
+
+    for (int i = 0; i < CHILDREN; ++i)
+    {
+        snprintf(argBuffer, sizeof(argBuffer), "%d", i + 1);
+        pids[i] = k_spawn("SchedulerTest40-Child", ExitWithArg, argBuffer, THREADS_MIN_STACK_SIZE, 1);
+    }
+
+    console_output(FALSE, "%s: k_waitpid(-1, WAIT_NOHANG) returned %d\n", testName,
+        k_waitpid(-1, &status, WAIT_NOHANG));
+    console_output(FALSE, "%s: k_waitpid(first, WAIT_NOHANG) returned %d\n", testName,
+        k_waitpid(pids[0], &status, WAIT_NOHANG));
+
+    kidpid = k_waitpid(pids[CHILDREN - 1], &status, 0);
+    console_output(FALSE, "%s: waited for the last child: %s, exit status %d\n", testName,
+        kidpid == pids[CHILDREN - 1] ? "pid matches" : "WRONG PID", status);
+
+    for (int i = CHILDREN - 2; i >= 0; --i)
+    {
+        kidpid = k_waitpid(pids[i], &status, WAIT_NOHANG);
+        if (kidpid == 0)
+        {
+            running++;
+            kidpid = k_waitpid(pids[i], &status, 0);
+        }
+        if (kidpid == pids[i] && status == i + 1)
+        {
+            matched++;
+        }
+    }
+    console_output(FALSE, "%s: reaped %d of %d children by pid, %d still running after the wait\n",
+        testName, matched, CHILDREN - 1, running);
+
+    console_output(FALSE, "%s: k_waitpid(0) returned %d\n", testName, k_waitpid(0, &status, 0));
+    console_output(FALSE, "%s: k_waitpid(reaped pid) returned %d\n", testName, k_waitpid(pids[0], &status, 0));
+    console_output(FALSE, "%s: k_waitpid(-1) with no children returned %d\n", testName,
+        k_waitpid(-1, &status, 0));
+
+    for (int i = 0; i < 3; ++i)
+    {
+        snprintf(argBuffer, sizeof(argBuffer), "%d", i + 1);
+        pids[i] = k_spawn("SchedulerTest40-Child", ExitWithArg, argBuffer, THREADS_MIN_STACK_SIZE, 1);
+    }
+    for (int i = 0; i < 3; ++i)
+    {
+        k_join(pids[i], &status);
+    }
+    for (int i = 0; i < 3; ++i)
+    {
+        kidpid = k_wait(&status);
+        console_output(FALSE, "%s: k_wait reaped child %d with exit status %d\n", testName,
+            kidpid == pids[i] ? i + 1 : -1, status);
+    }
+
+    k_exit(0);
+
+    return 0;
+}
+
+/*
+*  ExitWithArg - exits with the number in its argument.
+*/
+int ExitWithArg(char* strArgs)
+{
+    k_exit(atoi(strArgs));
+
+    return 0;
+}
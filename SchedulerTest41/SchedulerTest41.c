@@ -0,0 +1,95 @@
+#include <stdio.h>
+#include "THREADSLib.h"
+#include "SchedulerTesting.h"
+#include "Scheduler.h"
+
+#define WORKERS 2000
+
+int Parent(char* strArgs);
+int ExitWithArg(char* strArgs);
+
+static int workerPids[WORKERS];
+
+/*********************************************************************************
+*
+* SchedulerTest41
+*
+* Child lists.  A parent spawns 2000 low priority workers and waits by pid for
+* the one in the middle, then for each of the first half, so they leave its
+* child list from the middle and the head.  It exits with the second half
+* still running.  They become orphans: the test joins each one, which must
+* see its exit code, and k_wait must then find no children other than the
+* parent.
+*
+*********************************************************************************/
+int SchedulerEntryPoint(void* pArgs)
+{
+    char* testName = "SchedulerTest41";
+    int status = -1, kidpid = -1, joined = 0;
+
+    console_output(FALSE, "\n%s: started\n", testName);
+    set_process_limit(WORKERS + 4);
+
+    kidpid = k_spawn("SchedulerTest41-Parent", Parent, NULL, THREADS_MIN_STACK_SIZE * 2, 3);
+    kidpid = kidpid == k_wait(&status) ? kidpid : -1;
+    console_output(FALSE, "%s: parent %s with exit status %d\n", testName,
+        kidpid > 0 ? "quit" : "WRONG PID", status);
+
+    for (int i = WORKERS / 2 + 1; i < WORKERS; ++i)
+    {
+        if (k_join(workerPids[i], &status) == 0 && status == i + 1)
+        {
+            joined++;
+        }
+    }
+    console_output(FALSE, "%s: joined %d of %d orphans\n", testName, joined, WORKERS / 2 - 1);
+    console_output(FALSE, "%s: k_wait with only orphans left returned %d\n", testName, k_wait(&status));
+
+    k_exit(0);
+
+    return 0;
+}
+
+/*
+*  Parent - spawns the workers, reaps the first half and exits.
+*/
+int Parent(char* strArgs)
+{
+    char argBuffer[32];
+    int status = -1, reaped = 0;
+
+    for (int i = 0; i < WORKERS; ++i)
+    {
+        snprintf(argBuffer, sizeof(argBuffer), "%d", i + 1);
+        workerPids[i] = k_spawn("SchedulerTest41-Worker", ExitWithArg, argBuffer, THREADS_MIN_STACK_SIZE, 1);
+    }
+
+    if (k_waitpid(workerPids[WORKERS / 2], &status, 0) == workerPids[WORKERS / 2] && status == WORKERS / 2 + 1)
+    {
+        reaped++;
+    }
+    for (int i = 0; i < WORKERS / 2; ++i)
+    {
+        if (k_waitpid(workerPids[i], &status, 0) == workerPids[i] && status == i + 1)
+        {
+            reaped++;
+        }
+    }
+    console_output(FALSE, "SchedulerTest41: parent reaped %d of %d workers\n", reaped, WORKERS / 2 + 1);
+    console_output(FALSE, "SchedulerTest41: parent k_waitpid(-1, WAIT_NOHANG) returned %d\n",
+        k_waitpid(-1, &status, WAIT_NOHANG));
+
+    k_exit(7);
+
+    return 0;
+}
+
+/*
+*  ExitWithArg - exits with the number in its argument.
+*/
+int ExitWithArg(char* strArgs)
+{
+    k_exit(atoi(strArgs));
+
+    return 0;
+}
@@ -0,0 +1,129 @@
+#include <stdio.h>
+#include "THREADSLib.h"
+#include "SchedulerTesting.h"
+#include "Scheduler.h"
+
+#define JOINERS 3
+
+int Joiner(char* strArgs);
+int Killer(char* strArgs);
+int ExitNine(char* strArgs);
+int Periodic(char* strArgs);
+
+static int targetPid;
+static int periodicPid;
+static int joinerPids[JOINERS];
+
+/*********************************************************************************
+*
+* SchedulerTest42
+*
+* k_kill on blocked processes.  Three joiners block in k_join on a low
+* priority target.  A fourth process signals the middle joiner, which must
+* come off the target's joiners and see k_join return -5, while the other
+* two still get the target's exit code of 9.  The signaling process then
+* checks the error returns of k_kill, signals itself, and expects
+* signaled() to be TRUE and k_join to return -5 without blocking, which
+* clears the signal.
+*
+* A real-time process waiting for its next period is signaled as well.  It
+* is not woken early; k_wait_next_period returns -5 at the next release.
+*
+*********************************************************************************/
+int SchedulerEntryPoint(void* pArgs)
+{
+    char* testName = "SchedulerTest42";
+    char nameBuffer[512];
+    int status = -1, kidpid;
+
+    console_output(FALSE, "\n%s: started\n", testName);
+
+    /* Real-time, so it runs at once and is waiting for its next period
+       before anything else starts. */
+    snprintf(nameBuffer, sizeof(nameBuffer), "%s-Periodic", testName);
+    periodicPid = k_spawn_rt(nameBuffer, Periodic, nameBuffer, THREADS_MIN_STACK_SIZE, 5, 20, 20);
+    for (int i = 0; i < JOINERS; ++i)
+    {
+        snprintf(nameBuffer, sizeof(nameBuffer), "%s-Joiner%d", testName, i + 1);
+        joinerPids[i] = k_spawn(nameBuffer, Joiner, nameBuffer, THREADS_MIN_STACK_SIZE, 2);
+    }
+    snprintf(nameBuffer, sizeof(nameBuffer), "%s-Killer", testName);
+    k_spawn(nameBuffer, Killer, nameBuffer, THREADS_MIN_STACK_SIZE, 2);
+    snprintf(nameBuffer, sizeof(nameBuffer), "%s-Target", testName);
+    targetPid = k_spawn(nameBuffer, ExitNine, nameBuffer, THREADS_MIN_STACK_SIZE, 1);
+
+    for (int i = 0; i < JOINERS + 3; ++i)
+    {
+        kidpid = k_wait(&status);
+        console_output(FALSE, "%s: exit status for child %d is %d\n", testName, kidpid, status);
+    }
+
+    k_exit(0);
+
+    return 0;
+}
+
+/*
+*  Joiner - joins the target and exits with what k_join returned.
+*/
+int Joiner(char* strArgs)
+{
+    int status = -1;
+    int result;
+
+    result = k_join(targetPid, &status);
+    console_output(FALSE, "%s: k_join returned %d, status %d\n", strArgs, result, result == 0 ? status : -1);
+
+    k_exit(result);
+
+    return 0;
+}
+
+/*
+*  Killer - signals the middle joiner, then itself.
+*/
+int Killer(char* strArgs)
+{
+    int status = -1;
+
+    console_output(FALSE, "%s: k_kill(middle joiner) returned %d\n", strArgs, k_kill(joinerPids[1], SIG_TERM));
+    console_output(FALSE, "%s: k_kill(periodic) returned %d\n", strArgs, k_kill(periodicPid, SIG_TERM));
+    console_output(FALSE, "%s: k_kill(no such pid) returned %d\n", strArgs, k_kill(0x7fff0000, SIG_TERM));
+    console_output(FALSE, "%s: k_kill(bad signal) returned %d\n", strArgs, k_kill(targetPid, MAX_SIGNAL + 1));
+
+    console_output(FALSE, "%s: signaled() before signaling itself is %d\n", strArgs, signaled());
+    k_kill(k_getpid(), SIG_TERM);
+    console_output(FALSE, "%s: signaled() after is %d\n", strArgs, signaled());
+    console_output(FALSE, "%s: k_join while signaled returned %d\n", strArgs, k_join(targetPid, &status));
+    console_output(FALSE, "%s: signaled() after k_join is %d\n", strArgs, signaled());
+
+    k_exit(-1);
+
+    return 0;
+}
+
+/*
+*  Periodic - waits for its next period until it is signaled.
+*/
+int Periodic(char* strArgs)
+{
+    int result;
+
+    while ((result = k_wait_next_period()) == 0)
+        ;
+    console_output(FALSE, "%s: k_wait_next_period returned %d\n", strArgs, result);
+
+    k_exit(result);
+
+    return 0;
+}
+
+/*
+*  ExitNine - exits with 9.
+*/
+int ExitNine(char* strArgs)
+{
+    k_exit(9);
+
+    return 0;
+}
@@ -0,0 +1,82 @@
+#include <stdio.h>
+#include "THREADSLib.h"
+#include "SchedulerTesting.h"
+#include "Scheduler.h"
+
+int Blocker(char* strArgs);
+int Unblocker(char* strArgs);
+
+static int blockerPid;
+
+/*********************************************************************************
+*
+* SchedulerTest43
+*
+* unblock.  A priority 4 child blocks in block(14).  A priority 2 child
+* checks that unblock fails with -1 for a pid that does not exist and -2
+* for a process that is not blocked in block() (itself), then unblocks the
+* first child, which sees block() return 0 and exits with 5.  Once the
+* blocker has been joined its pid is stale and unblock returns -1.
+*
+*********************************************************************************/
+int SchedulerEntryPoint(void* pArgs)
+{
+    char* testName = "SchedulerTest43";
+    char nameBuffer[512];
+    int status = -1, kidpid;
+
+    console_output(FALSE, "\n%s: started\n", testName);
+
+    snprintf(nameBuffer, sizeof(nameBuffer), "%s-Blocker", testName);
+    blockerPid = k_spawn(nameBuffer, Blocker, nameBuffer, THREADS_MIN_STACK_SIZE, 4);
+    snprintf(nameBuffer, sizeof(nameBuffer), "%s-Unblocker", testName);
+    k_spawn(nameBuffer, Unblocker, nameBuffer, THREADS_MIN_STACK_SIZE, 2);
+
+    for (int i = 0; i < 2; ++i)
+    {
+        kidpid = k_wait(&status);
+        console_output(FALSE, "%s: exit status for child %d is %d\n", testName, kidpid, status);
+    }
+
+    k_exit(0);
+
+    return 0;
+}
+
+/*
+*  Blocker - blocks until unblocked and exits with 5.
+*/
+int Blocker(char* strArgs)
+{
+    console_output(FALSE, "%s: blocking\n", strArgs);
+    console_output(FALSE, "%s: block returned %d\n", strArgs, block(14));
+
+    k_exit(5);
+
+    return 0;
+}
+
+/*
+*  Unblocker - checks the error returns, then unblocks the blocker.
+*/
+int Unblocker(char* strArgs)
+{
+    int status = -1;
+    int result;
+
+    console_output(FALSE, "%s: unblock(no such pid) returned %d\n", strArgs, unblock(0x7fff0000));
+    console_output(FALSE, "%s: unblock(self) returned %d\n", strArgs, unblock(k_getpid()));
+
+    /* Other policies may run this first; -2 until the blocker has blocked. */
+    while ((result = unblock(blockerPid)) == -2)
+        ;
+    console_output(FALSE, "%s: unblock(blocker) returned %d\n", strArgs, result);
+
+    result = k_join(blockerPid, &status);
+    console_output(FALSE, "%s: k_join returned %d, status %d\n", strArgs, result, status);
+    console_output(FALSE, "%s: unblock(exited blocker) returned %d\n", strArgs, unblock(blockerPid));
+
+    k_exit(0);
+
+    return 0;
+}
@@ -0,0 +1,89 @@
+#include <stdio.h>
+#include "THREADSLib.h"
+#include "SchedulerTesting.h"
+#include "Scheduler.h"
+
+#define OVERRUN_JOBS 3
+
+int Overrun(char* strArgs);
+int CpuHog(char* strArgs);
+
+/*********************************************************************************
+*
+* SchedulerTest44
+*
+* Real-time budget enforcement.  A k_spawn_rt process reserves 10 ms every
+* 50 ms but needs 30 ms of CPU for each job.  Each job is throttled once it
+* has used its 10 ms (up to a clock tick later without SCHEDULER_TICKLESS), so
+* it takes at least 40 ms to finish instead of 30 ms, and every job misses
+* its deadline.  Meanwhile a priority 5 process gets the CPU the real-time
+* process is not allowed to use.
+*
+*********************************************************************************/
+int SchedulerEntryPoint(void* pArgs)
+{
+    char* testName = "SchedulerTest44";
+    int status = -1, kidpid = -1;
+    char nameBuffer[512];
+
+    console_output(FALSE, "\n%s: started\n", testName);
+
+    snprintf(nameBuffer, sizeof(nameBuffer), "%s-Overrun", testName);
+    kidpid = k_spawn_rt(nameBuffer, Overrun, nameBuffer, THREADS_MIN_STACK_SIZE, 10, 50, 50);
+    console_output(FALSE, "%s: after spawn of real-time child with pid %d\n", testName, kidpid);
+
+    snprintf(nameBuffer, sizeof(nameBuffer), "%s-CpuHog", testName);
+    kidpid = k_spawn(nameBuffer, CpuHog, nameBuffer, THREADS_MIN_STACK_SIZE, 5);
+    console_output(FALSE, "%s: after spawn of child with pid %d\n", testName, kidpid);
+
+    for (int i = 0; i < 2; ++i)
+    {
+        kidpid = k_wait(&status);
+        console_output(FALSE, "%s: exit status for child %d is %d\n", testName, kidpid, status);
+    }
+
+    k_exit(0);
+
+    return 0;
+}
+
+/*
+*  Overrun - jobs of 30 ms of CPU time against a 10 ms budget.
+*/
+int Overrun(char* strArgs)
+{
+    unsigned int jobStart, cpuStart;
+    int misses;
+
+    for (int i = 0; i < OVERRUN_JOBS; ++i)
+    {
+        jobStart = read_clock() / 1000;
+        cpuStart = read_time();
+        while (read_time() - cpuStart < 30)
+            ;
+        console_output(FALSE, "%s: job %d took %s40 ms\n", strArgs, i + 1,
+            read_clock() / 1000 - jobStart >= 40 ? "at least " : "LESS THAN ");
+        k_wait_next_period();
+    }
+    misses = get_deadline_misses(k_getpid());
+    console_output(FALSE, "%s: %d jobs, %s\n", strArgs, OVERRUN_JOBS,
+        misses >= OVERRUN_JOBS ? "every job missed its deadline" : "SOME JOBS MET THEIR DEADLINE");
+
+    k_exit(misses);
+
+    return 0;
+}
+
+/*
+*  CpuHog - busy waits for half a second.
+*/
+int CpuHog(char* strArgs)
+{
+    console_output(FALSE, "%s: started\n", strArgs);
+    SystemDelay(500);
+    console_output(FALSE, "%s: quitting after %d ms of CPU\n", strArgs, read_time());
+
+    k_exit(-4);
+
+    return 0;
+}
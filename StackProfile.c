@@ -0,0 +1,162 @@
+#include <stdio.h>
+#include "THREADSLib.h"
+#include "Scheduler.h"
+#include "Processes.h"
+#include "ProcessTable.h"
+#include "StringArena.h"
+#include "StackProfile.h"
+
+/* One entry per entry point, found by hashing the function address.
+   Entry points beyond STACK_PROFILE_ENTRIES are counted but not kept. */
+#define STACK_PROFILE_ENTRIES   128
+
+typedef struct
+{
+    int (*entryPoint)(void*);
+    const char* name;               /* first process seen, interned */
+    int processes;
+    int stackSize;                  /* largest k_spawn stack size */
+    unsigned int maxUsed;
+    uint64_t totalUsed;
+} StackProfileEntry;
+
+static StackProfileEntry profile[STACK_PROFILE_ENTRIES];
+static int profileLevel;
+static int droppedProcesses;
+
+extern int debugFlag;
+
+/**************************************************************************
+   Name - set_stack_profiling
+
+   Purpose - Turns stack high-water profiling on or off.  While it is on
+             new stacks are painted, which commits them in full, and
+             each process's deepest stack use is added to the summary
+             printed by display_stack_profile() when it exits.  Only
+             THREADSLinux can paint stacks; with the prebuilt THREADS.lib
+             the level is kept but nothing is recorded.
+
+   Parameters - 0 off, 1 summary only, 2 also report every process at
+                k_exit
+
+   Returns - the previous level
+
+*************************************************************************/
+int set_stack_profiling(int level)
+{
+    int previous = profileLevel;
+
+    profileLevel = level;
+#ifdef __linux__
+    context_stack_paint(level != 0);
+#endif
+
+    return previous;
+}
+
+/**************************************************************************
+   Name - display_stack_profile
+
+   Purpose - Prints the stack use of the processes that have exited, per
+             entry point: how many ran, the stack size they asked for,
+             the deepest and average use, and the smallest multiple of
+             THREADS_MIN_STACK_SIZE that would have held the deepest.
+             Use includes the host frames the runtime reserves room for
+             on top of the requested size, so it can exceed it.
+
+*************************************************************************/
+void display_stack_profile(void)
+{
+    StackProfileEntry* pEntry;
+    int entries = 0;
+
+    for (int i = 0; i < STACK_PROFILE_ENTRIES; ++i)
+    {
+        entries += profile[i].processes != 0;
+    }
+    if (entries == 0)
+    {
+        return;
+    }
+
+    console_output(FALSE, "%-20s%-11s%-11s%-11s%-11s%-11s%s\n",
+        "Entry point", "Processes", "Stack(KB)", "Max(KB)", "Avg(KB)", "Fit(KB)", "First process");
+    for (int i = 0; i < STACK_PROFILE_ENTRIES; ++i)
+    {
+        pEntry = &profile[i];
+        if (pEntry->processes == 0)
+        {
+            continue;
+        }
+        console_output(FALSE, "%-20p%-11d%-11d%-11u%-11u%-11u%s\n", (void*)pEntry->entryPoint,
+            pEntry->processes, pEntry->stackSize / 1024, pEntry->maxUsed / 1024,
+            (unsigned int)(pEntry->totalUsed / pEntry->processes / 1024),
+            (pEntry->maxUsed + THREADS_MIN_STACK_SIZE - 1) / THREADS_MIN_STACK_SIZE * THREADS_MIN_STACK_SIZE / 1024,
+            pEntry->name);
+    }
+    if (droppedProcesses != 0)
+    {
+        console_output(FALSE, "(%d processes of further entry points not shown)\n", droppedProcesses);
+    }
+}
+
+/* ---------------------------------------------------------------
+    StackProfileRecord
+
+    Purpose - Adds an exiting process's stack high water to the
+                entry for its entry point
+    Parameters - the exiting process
+--------------------------------------------------------------- */
+void StackProfileRecord(Process* pProc)
+{
+    ProcessCold* pCold = ProcessColdOf(pProc);
+    StackProfileEntry* pEntry = NULL;
+    unsigned int used = 0;
+    unsigned int slot = (unsigned int)(((uintptr_t)pCold->entryPoint >> 4) % STACK_PROFILE_ENTRIES);
+
+#ifdef __linux__
+    if (profileLevel != 0)
+    {
+        used = context_stack_high_water(pProc->context);
+    }
+#endif
+    if (used == 0)
+    {
+        return;
+    }
+    if (profileLevel > 1)
+    {
+        console_output(debugFlag, "k_exit(): process %d (%s) used %u of %d stack bytes\n",
+            pProc->pid, pCold->name, used, pCold->stackSize);
+    }
+
+    for (int i = 0; i < STACK_PROFILE_ENTRIES; ++i, slot = (slot + 1) % STACK_PROFILE_ENTRIES)
+    {
+        if (profile[slot].processes == 0 || profile[slot].entryPoint == pCold->entryPoint)
+        {
+            pEntry = &profile[slot];
+            break;
+        }
+    }
+    if (pEntry == NULL)
+    {
+        droppedProcesses++;
+        return;
+    }
+
+    if (pEntry->processes == 0)
+    {
+        pEntry->entryPoint = pCold->entryPoint;
+        pEntry->name = StringArenaIntern(pCold->name);
+    }
+    pEntry->processes++;
+    pEntry->totalUsed += used;
+    if (used > pEntry->maxUsed)
+    {
+        pEntry->maxUsed = used;
+    }
+    if (pCold->stackSize > pEntry->stackSize)
+    {
+        pEntry->stackSize = pCold->stackSize;
+    }
+}
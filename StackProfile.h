@@ -0,0 +1,5 @@
+#pragma once
+
+/* Stack high-water profiling (set_stack_profiling).  Each process's deepest
+   stack use is recorded at k_exit and summarised per entry point. */
+void StackProfileRecord(Process* pProc);
@@ -0,0 +1,225 @@
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include "THREADSLib.h"
+#include "StringArena.h"
+
+/* Entries up to ARENA_LARGEST bytes are carved from ARENA_BLOCK_SIZE
+   blocks in ARENA_GRANULE steps and recycled through a free list per
+   size; longer strings get their own allocation. */
+#define ARENA_GRANULE       32
+#define ARENA_LARGEST       512
+#define ARENA_CLASSES       (ARENA_LARGEST / ARENA_GRANULE)
+#define ARENA_BLOCK_SIZE    16384
+#define ARENA_MIN_BUCKETS   64
+
+typedef struct _arena_string
+{
+    struct _arena_string* pNext;    /* hash chain, or free list */
+    unsigned int hash;
+    int references;
+    int size;                       /* entry bytes, 0 if allocated alone */
+    char text[];
+} ArenaString;
+
+static ArenaString** buckets;
+static unsigned int bucketCount;
+static unsigned int stringCount;
+static ArenaString* freeLists[ARENA_CLASSES];
+static char* pBlockNext;
+static char* pBlockEnd;
+static int arenaBytes;
+
+static ArenaString* AllocateEntry(int length);
+static void FreeEntry(ArenaString* pEntry);
+static int GrowBuckets(void);
+static unsigned int HashString(const char* pString, int* pLength);
+
+/* ---------------------------------------------------------------
+    StringArenaIntern
+
+    Purpose - Returns the shared copy of a string, adding a
+                reference.  Only a string that is not already in the
+                arena is copied.
+    Parameters - the string to intern
+    Returns - the interned string, or NULL if out of memory
+--------------------------------------------------------------- */
+const char* StringArenaIntern(const char* pString)
+{
+    ArenaString* pEntry;
+    unsigned int hash;
+    int length;
+
+    if (stringCount >= bucketCount && !GrowBuckets() && bucketCount == 0)
+    {
+        return NULL;
+    }
+
+    hash = HashString(pString, &length);
+    for (pEntry = buckets[hash & (bucketCount - 1)]; pEntry != NULL; pEntry = pEntry->pNext)
+    {
+        if (pEntry->hash == hash && strcmp(pEntry->text, pString) == 0)
+        {
+            pEntry->references++;
+            return pEntry->text;
+        }
+    }
+
+    pEntry = AllocateEntry(length);
+    if (pEntry == NULL)
+    {
+        return NULL;
+    }
+    memcpy(pEntry->text, pString, length + 1);
+    pEntry->hash = hash;
+    pEntry->references = 1;
+    pEntry->pNext = buckets[hash & (bucketCount - 1)];
+    buckets[hash & (bucketCount - 1)] = pEntry;
+    stringCount++;
+
+    return pEntry->text;
+}
+
+/* ---------------------------------------------------------------
+    StringArenaRelease
+
+    Purpose - Drops a reference taken by StringArenaIntern and frees
+                the string with the last one
+    Parameters - an interned string, or NULL
+--------------------------------------------------------------- */
+void StringArenaRelease(const char* pString)
+{
+    ArenaString* pEntry;
+    ArenaString** ppLink;
+
+    if (pString == NULL)
+    {
+        return;
+    }
+
+    pEntry = (ArenaString*)(pString - offsetof(ArenaString, text));
+    if (--pEntry->references > 0)
+    {
+        return;
+    }
+
+    for (ppLink = &buckets[pEntry->hash & (bucketCount - 1)]; *ppLink != pEntry; ppLink = &(*ppLink)->pNext)
+        ;
+    *ppLink = pEntry->pNext;
+    stringCount--;
+    FreeEntry(pEntry);
+}
+
+/* ---------------------------------------------------------------
+    StringArenaBytes
+
+    Returns - the bytes the arena holds for strings, in use or free
+--------------------------------------------------------------- */
+int StringArenaBytes(void)
+{
+    return arenaBytes;
+}
+
+/* Takes an entry for a string of the given length from the free list for
+   its size, the current block, or a new block. */
+static ArenaString* AllocateEntry(int length)
+{
+    ArenaString* pEntry;
+    int size = (int)((offsetof(ArenaString, text) + length + 1 + ARENA_GRANULE - 1) & ~(ARENA_GRANULE - 1));
+    int sizeClass = size / ARENA_GRANULE - 1;
+
+    if (size > ARENA_LARGEST)
+    {
+        pEntry = malloc(offsetof(ArenaString, text) + length + 1);
+        if (pEntry != NULL)
+        {
+            pEntry->size = 0;
+            arenaBytes += (int)(offsetof(ArenaString, text) + length + 1);
+        }
+        return pEntry;
+    }
+
+    if (freeLists[sizeClass] != NULL)
+    {
+        pEntry = freeLists[sizeClass];
+        freeLists[sizeClass] = pEntry->pNext;
+        return pEntry;
+    }
+
+    /* The tail of a block too short for this entry is left unused. */
+    if (pBlockNext == NULL || pBlockEnd - pBlockNext < size)
+    {
+        pBlockNext = malloc(ARENA_BLOCK_SIZE);
+        if (pBlockNext == NULL)
+        {
+            pBlockEnd = NULL;
+            return NULL;
+        }
+        pBlockEnd = pBlockNext + ARENA_BLOCK_SIZE;
+        arenaBytes += ARENA_BLOCK_SIZE;
+    }
+    pEntry = (ArenaString*)pBlockNext;
+    pBlockNext += size;
+    pEntry->size = size;
+    return pEntry;
+}
+
+/* Long strings go back to the heap; the rest to their free list. */
+static void FreeEntry(ArenaString* pEntry)
+{
+    int sizeClass;
+
+    if (pEntry->size == 0)
+    {
+        arenaBytes -= (int)(offsetof(ArenaString, text) + strlen(pEntry->text) + 1);
+        free(pEntry);
+        return;
+    }
+
+    sizeClass = pEntry->size / ARENA_GRANULE - 1;
+    pEntry->pNext = freeLists[sizeClass];
+    freeLists[sizeClass] = pEntry;
+}
+
+/* Doubles the hash table.  Failing leaves the old table in place,
+   which still works, only with longer chains. */
+static int GrowBuckets(void)
+{
+    unsigned int newCount = bucketCount == 0 ? ARENA_MIN_BUCKETS : bucketCount * 2;
+    ArenaString** newBuckets = calloc(newCount, sizeof(ArenaString*));
+    ArenaString* pEntry;
+    ArenaString* pNext;
+
+    if (newBuckets == NULL)
+    {
+        return FALSE;
+    }
+
+    for (unsigned int i = 0; i < bucketCount; ++i)
+    {
+        for (pEntry = buckets[i]; pEntry != NULL; pEntry = pNext)
+        {
+            pNext = pEntry->pNext;
+            pEntry->pNext = newBuckets[pEntry->hash & (newCount - 1)];
+            newBuckets[pEntry->hash & (newCount - 1)] = pEntry;
+        }
+    }
+    free(buckets);
+    buckets = newBuckets;
+    bucketCount = newCount;
+    return TRUE;
+}
+
+/* FNV-1a, returning the length as well so the string is read once. */
+static unsigned int HashString(const char* pString, int* pLength)
+{
+    unsigned int hash = 2166136261u;
+    const char* p;
+
+    for (p = pString; *p != '\0'; ++p)
+    {
+        hash = (hash ^ (unsigned char)*p) * 16777619u;
+    }
+    *pLength = (int)(p - pString);
+    return hash;
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+/* Kernel string arena for process names and start arguments.  Strings are
+   interned: equal strings share one reference counted copy, so spawning a
+   process whose name or argument is already in use copies nothing, and a
+   string is only as long as it needs to be.  Interned strings are shared
+   and must not be modified. */
+const char* StringArenaIntern(const char* pString);
+void        StringArenaRelease(const char* pString);
+int         StringArenaBytes(void);
@@ -0,0 +1,61 @@
+/*
+ * ContextBench.c
+ *
+ * Ping-pong benchmark for the THREADSLinux context backends.  Two contexts
+ * switch back and forth through context_switch() and the average cost of
+ * one switch is reported.  The Makefile links it against both the x86-64
+ * assembly backend and the generic ucontext backend.
+ *
+ * Stands in for the scheduler: it provides bootstrap() itself.
+ */
+#include <stdio.h>
+#include "THREADSLib.h"
+
+#define PING_PONG_ROUNDS    1000000
+
+static void* pingContext;
+static void* pongContext;
+
+static int Ping(void* pArgs)
+{
+    uint32_t startTime, elapsed;
+
+    startTime = system_clock();
+    for (int i = 0; i < PING_PONG_ROUNDS; ++i)
+    {
+        context_switch(pongContext);
+    }
+    elapsed = system_clock() - startTime;
+
+    /* Two switches per round. */
+    console_output(false, "ContextBench (%s): %.1f ns per switch\n", (char*)pArgs,
+        elapsed * 1000.0 / (2.0 * PING_PONG_ROUNDS));
+    stop(0);
+    return 0;
+}
+
+static int Pong(void* pArgs)
+{
+    (void)pArgs;
+    while (1)
+    {
+        context_switch(pingContext);
+    }
+    return 0;
+}
+
+int bootstrap(void* pArgs)
+{
+#ifdef THREADS_CONTEXT_UCONTEXT
+    char* backend = "ucontext";
+#else
+    char* backend = "asm";
+#endif
+
+    (void)pArgs;
+    pingContext = context_initialize(Ping, THREADS_MIN_STACK_SIZE, backend);
+    pongContext = context_initialize(Pong, THREADS_MIN_STACK_SIZE, NULL);
+
+    context_switch(pingContext);
+    return 0;
+}
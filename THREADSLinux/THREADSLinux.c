@@ -0,0 +1,881 @@
+/*
+ * THREADSLinux.c
+ *
+ * Linux-hosted stand-in for the prebuilt THREADS runtime (Lib/THREADS.lib,
+ * bin/THREADS.dll).  Implements the interface declared in THREADSLib.h with
+ * an ITIMER_REAL/SIGALRM timer for THREADS_TIMER_INTERRUPT, so Scheduler.c
+ * and the test programs build and run natively (and can be profiled with
+ * perf).
+ *
+ * Context backends: on x86-64 contexts are switched by
+ * ContextSwitch_x86_64.S, which saves only callee-saved registers.  Building
+ * with -DTHREADS_CONTEXT_UCONTEXT (or on any other architecture) selects the
+ * generic ucontext backend, which also saves and restores the signal mask.
+ *
+ * Interrupt model: the PSR is a single word owned by this file and saved
+ * with each context, so a context resumes in the mode it was switched out
+ * in (always with interrupts enabled).  The timer signal is only delivered
+ * to the installed handler while PSR_INTERRUPTS is set; otherwise it is
+ * latched and delivered as soon as set_psr() enables interrupts again.
+ * While the handler runs the PSR is in kernel + IRQ mode with interrupts
+ * disabled, and it is restored when the handler returns.  The handler can
+ * switch contexts, so it must never land inside libc (stdio and malloc
+ * locks, a half-updated heap): every runtime path that calls libc runs
+ * between MaskInterrupts() and RestoreInterrupts(), which latches a tick
+ * that arrives meanwhile and delivers it once the call is done.
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <time.h>
+#include <ucontext.h>
+#include <sys/time.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "THREADSLib.h"
+
+#if defined(__x86_64__) && !defined(THREADS_CONTEXT_UCONTEXT)
+#define THREADS_CONTEXT_ASM 1
+#else
+#define THREADS_CONTEXT_ASM 0
+#endif
+
+/* Clock interrupt period.  The scheduler's 80 ms time slice is four ticks. */
+#define THREADS_CLOCK_TICK_US       20000
+
+/* Host libc frames (printf, signal delivery) run on process stacks.  The
+   Windows fiber runtime hides that cost, so every stack gets this much on
+   top of what the caller asked for. */
+#define THREADS_HOST_STACK_RESERVE  (64 * 1024)
+
+/* Stacks are anonymous mappings, so pages are only committed when first
+   touched, with an inaccessible guard page below each one that turns an
+   overflow into a fault instead of silent corruption.  A guard page splits
+   the mapping, so a guarded stack costs two of the vm.max_map_count
+   (65530 by default) kernel mappings.  Only THREADS_GUARDED_STACKS stacks
+   get a guard; the rest are plain mappings, which the kernel merges with
+   their neighbours, so a table of tens of thousands of processes does not
+   run out of mappings.
+
+   Stack pool.  A stopped context keeps its stack and goes on the free list
+   for its size class (a multiple of THREADS_MIN_STACK_SIZE), so a spawn
+   after an exit reuses both without going to the allocator.  Stacks above
+   the largest class are not pooled, the pool holds at most
+   THREADS_STACK_POOL_BYTES, and context_pool_trim() empties it. */
+#define THREADS_STACK_CLASSES       32
+#define THREADS_GUARDED_STACKS      16384
+#define THREADS_STACK_POOL_BYTES    (16 * 1024 * 1024)
+
+/* Stack painting (context_stack_paint).  New stacks are filled with this
+   byte so context_stack_high_water() can find the deepest byte a context
+   has written.  Painting commits the whole stack, so it is off by default. */
+#define THREADS_STACK_PAINT         0xCD
+
+typedef struct threads_context
+{
+#if THREADS_CONTEXT_ASM
+    void*                   sp;             /* saved stack pointer */
+#else
+    ucontext_t              uc;
+#endif
+    uint32_t                psr;            /* PSR while switched out */
+    void*                   stack;          /* lowest usable byte, above any guard page */
+    size_t                  stack_size;
+    process_entrypoint_t    entry_point;
+    void*                   args;
+    int                     size_class;     /* stack pool class, 0 if not pooled */
+    bool                    painted;        /* stack was painted when created */
+    bool                    guarded;        /* stack has a guard page below it */
+    struct threads_context* pNextFree;      /* stack pool free list */
+} threads_context_t;
+
+static threads_context_t    mainContext;
+static threads_context_t*   currentContext = &mainContext;
+static threads_context_t*   stoppedContext;     /* freed once we are off its stack */
+static threads_context_t*   stackPool[THREADS_STACK_CLASSES];
+static size_t               stackPoolBytes;
+static int                  guardedStacks;
+static size_t               pageSize;
+static bool                 stackPainting;
+
+static volatile sig_atomic_t psr = PSR_KERNEL_MODE;
+static volatile sig_atomic_t timerPending;
+
+static interrupt_handler_t   interruptVector[THREADS_INTERRUPT_HANDLER_COUNT];
+static system_call_handler_t systemCallVector[THREADS_MAX_SYSCALLS];
+
+static struct timespec       clockStart;
+static int                   debugLevel;
+
+static void DeliverTimerInterrupt(void);
+static uint32_t MaskInterrupts(void);
+static void RestoreInterrupts(uint32_t savedPsr);
+static uint32_t SetClockTimer(int mode, uint32_t microseconds);
+static void ReleaseStoppedContext(void);
+static threads_context_t* AllocateContext(int stack_size);
+static void FreeContext(threads_context_t* pContext);
+static bool MapStack(threads_context_t* pContext);
+static void UnmapStack(threads_context_t* pContext);
+static void PaintStack(threads_context_t* pContext);
+void ContextLaunch(void);
+
+#if THREADS_CONTEXT_ASM
+extern void threads_context_swap(void** pSaveSp, void* nextSp);
+extern void threads_context_entry(void);
+#endif
+
+/* Device table.  Disks are kept in memory, terminals map to stdio. */
+#define THREADS_DISK_TRACKS     64
+
+typedef struct
+{
+    char            name[THREADS_MAX_DEVICE_NAME];
+    device_type_t   type;
+    int             unit;
+    int             track;
+    uint8_t*        sectors;
+} threads_device_t;
+
+static threads_device_t deviceTable[THREADS_MAX_DEVICES];
+static int              deviceCount;
+
+
+/**************************************************************************
+   Name - ContextLaunch
+
+   Purpose - First code run on a new context.  Interrupts are enabled the
+             same way context_switch() enables them for a resumed context.
+             Process entry points are not expected to return.
+*************************************************************************/
+void ContextLaunch(void)
+{
+    int result;
+
+    psr = (sig_atomic_t)currentContext->psr;
+    ReleaseStoppedContext();
+    set_psr(psr | PSR_INTERRUPTS);
+
+    result = currentContext->entry_point(currentContext->args);
+
+    console_output(false, "THREADS: entry point returned %d, stopping\n", result);
+    stop(result);
+}
+
+/**************************************************************************
+   Name - context_initialize
+
+   Purpose - Creates a context that starts in entry_point(args) on a
+             stack of at least stack_size bytes, reusing a pooled stack
+             of the same size class when there is one.
+
+   Returns - an opaque context pointer for context_switch(), or NULL
+*************************************************************************/
+void* context_initialize(process_entrypoint_t entry_point, int stack_size, void* args)
+{
+    threads_context_t* pContext;
+    uint32_t savedPsr;
+
+    if (entry_point == NULL || stack_size <= 0)
+    {
+        return NULL;
+    }
+
+    savedPsr = MaskInterrupts();
+    pContext = AllocateContext(stack_size);
+    if (pContext == NULL)
+    {
+        /* Out of memory: give the pooled stacks back and try once more. */
+        context_pool_trim();
+        pContext = AllocateContext(stack_size);
+    }
+    if (pContext != NULL && (stackPainting || pContext->painted))
+    {
+        PaintStack(pContext);
+    }
+    RestoreInterrupts(savedPsr);
+    if (pContext == NULL)
+    {
+        return NULL;
+    }
+    pContext->entry_point = entry_point;
+    pContext->args = args;
+    pContext->psr = PSR_KERNEL_MODE;
+
+#if THREADS_CONTEXT_ASM
+    {
+        /* Hand-built threads_context_swap frame: default MXCSR and x87
+           control words, zeroed callee-saved registers, and a return into
+           threads_context_entry, which realigns and calls ContextLaunch. */
+        uint64_t* pFrame = (uint64_t*)(((uintptr_t)pContext->stack + pContext->stack_size) & ~(uintptr_t)15);
+
+        *--pFrame = 0;
+        *--pFrame = (uint64_t)(uintptr_t)threads_context_entry;
+        for (int i = 0; i < 6; ++i)
+        {
+            *--pFrame = 0;                          /* rbp, rbx, r12-r15 */
+        }
+        *--pFrame = 0x1F80ull | (0x037Full << 32);  /* mxcsr | x87 cw */
+        pContext->sp = pFrame;
+    }
+#else
+    getcontext(&pContext->uc);
+    pContext->uc.uc_stack.ss_sp = pContext->stack;
+    pContext->uc.uc_stack.ss_size = pContext->stack_size;
+    pContext->uc.uc_link = NULL;
+    sigemptyset(&pContext->uc.uc_sigmask);
+    makecontext(&pContext->uc, ContextLaunch, 0);
+#endif
+
+    return pContext;
+}
+
+/**************************************************************************
+   Name - context_switch
+
+   Purpose - Saves the running context and resumes next_context.  The
+             resumed context always runs with interrupts enabled.
+
+   Returns - true once this context is resumed, false on a bad argument
+*************************************************************************/
+bool context_switch(LPVOID next_context)
+{
+    threads_context_t* pPrevious = currentContext;
+    threads_context_t* pNext = next_context;
+
+    if (pNext == NULL)
+    {
+        return false;
+    }
+
+    if (pNext != pPrevious)
+    {
+        pPrevious->psr = (uint32_t)psr;
+        currentContext = pNext;
+#if THREADS_CONTEXT_ASM
+        threads_context_swap(&pPrevious->sp, pNext->sp);
+#else
+        swapcontext(&pPrevious->uc, &pNext->uc);
+#endif
+        psr = (sig_atomic_t)pPrevious->psr;
+        ReleaseStoppedContext();
+    }
+
+    set_psr(psr | PSR_INTERRUPTS);
+    return true;
+}
+
+/**************************************************************************
+   Name - context_stop
+
+   Purpose - Releases a context and its stack to the stack pool.  A
+             context cannot give up the stack it is running on, so the
+             running context is released on the next switch instead.
+*************************************************************************/
+void context_stop(LPVOID context)
+{
+    threads_context_t* pContext = context;
+    uint32_t savedPsr;
+
+    if (pContext == NULL || pContext == &mainContext)
+    {
+        return;
+    }
+
+    if (pContext == currentContext)
+    {
+        ReleaseStoppedContext();
+        stoppedContext = pContext;
+        return;
+    }
+
+    savedPsr = MaskInterrupts();
+    FreeContext(pContext);
+    RestoreInterrupts(savedPsr);
+}
+
+/**************************************************************************
+   Name - context_pool_trim
+
+   Purpose - Frees every stack held in the stack pool, e.g. under memory
+             pressure.  context_initialize() trims the pool itself before
+             failing for lack of memory.
+
+   Returns - the number of bytes released
+*************************************************************************/
+uint32_t context_pool_trim(void)
+{
+    threads_context_t* pContext;
+    size_t released = stackPoolBytes;
+    uint32_t savedPsr = MaskInterrupts();
+
+    for (int i = 0; i < THREADS_STACK_CLASSES; ++i)
+    {
+        while ((pContext = stackPool[i]) != NULL)
+        {
+            stackPool[i] = pContext->pNextFree;
+            UnmapStack(pContext);
+            free(pContext);
+        }
+    }
+    stackPoolBytes = 0;
+    RestoreInterrupts(savedPsr);
+
+    return (uint32_t)released;
+}
+
+/**************************************************************************
+   Name - context_stack_resident
+
+   Purpose - Measures how much of a context's stack has been committed,
+             i.e. the pages it has touched so far.
+
+   Returns - resident stack bytes, or 0 for no context
+*************************************************************************/
+uint32_t context_stack_resident(LPVOID context)
+{
+    threads_context_t* pContext = context;
+    unsigned char residency[256];
+    size_t pages, count, resident = 0;
+
+    if (pContext == NULL || pContext->stack == NULL)
+    {
+        return 0;
+    }
+
+    pages = (pContext->stack_size + pageSize - 1) / pageSize;
+    for (size_t first = 0; first < pages; first += count)
+    {
+        count = pages - first < sizeof(residency) ? pages - first : sizeof(residency);
+        if (mincore((char*)pContext->stack + first * pageSize, count * pageSize, residency) != 0)
+        {
+            return 0;
+        }
+        for (size_t i = 0; i < count; ++i)
+        {
+            resident += residency[i] & 1;
+        }
+    }
+
+    return (uint32_t)(resident * pageSize);
+}
+
+/**************************************************************************
+   Name - context_stack_paint
+
+   Purpose - Turns stack painting on or off for contexts created from now
+             on.  A pooled stack that was painted stays painted.
+*************************************************************************/
+void context_stack_paint(bool enabled)
+{
+    stackPainting = enabled;
+}
+
+/**************************************************************************
+   Name - context_stack_high_water
+
+   Purpose - Finds the deepest byte a context has written on its stack,
+             by scanning a painted stack up from the bottom for the first
+             byte that no longer holds the paint.
+
+   Returns - stack bytes used, measured from the top, or 0 if the stack
+             was not painted
+*************************************************************************/
+uint32_t context_stack_high_water(LPVOID context)
+{
+    threads_context_t* pContext = context;
+    const uint64_t paint = 0x0101010101010101ull * THREADS_STACK_PAINT;
+    const uint64_t* pWord;
+    const uint64_t* pEnd;
+    const unsigned char* pByte;
+
+    if (pContext == NULL || !pContext->painted)
+    {
+        return 0;
+    }
+
+    pWord = pContext->stack;
+    pEnd = (const uint64_t*)((char*)pContext->stack + (pContext->stack_size & ~(size_t)7));
+    while (pWord < pEnd && *pWord == paint)
+    {
+        pWord++;
+    }
+    for (pByte = (const unsigned char*)pWord; pByte < (const unsigned char*)pEnd && *pByte == THREADS_STACK_PAINT; ++pByte)
+        ;
+
+    return (uint32_t)(pContext->stack_size - (size_t)(pByte - (const unsigned char*)pContext->stack));
+}
+
+static void ReleaseStoppedContext(void)
+{
+    threads_context_t* pContext = stoppedContext;
+    uint32_t savedPsr;
+
+    if (pContext != NULL && pContext != currentContext)
+    {
+        savedPsr = MaskInterrupts();
+        stoppedContext = NULL;
+        FreeContext(pContext);
+        RestoreInterrupts(savedPsr);
+    }
+}
+
+/* Pops a pooled context for the stack size's class, or allocates one
+   with a stack of the full class size so it can be pooled later. */
+static threads_context_t* AllocateContext(int stack_size)
+{
+    threads_context_t* pContext;
+    int size_class = (stack_size + THREADS_MIN_STACK_SIZE - 1) / THREADS_MIN_STACK_SIZE;
+
+    if (size_class > THREADS_STACK_CLASSES)
+    {
+        size_class = 0;
+    }
+    else if (stackPool[size_class - 1] != NULL)
+    {
+        pContext = stackPool[size_class - 1];
+        stackPool[size_class - 1] = pContext->pNextFree;
+        stackPoolBytes -= pContext->stack_size;
+        pContext->pNextFree = NULL;
+        return pContext;
+    }
+
+    pContext = calloc(1, sizeof(threads_context_t));
+    if (pContext == NULL)
+    {
+        return NULL;
+    }
+
+    pContext->size_class = size_class;
+    pContext->stack_size = (size_class != 0 ? (size_t)size_class * THREADS_MIN_STACK_SIZE : (size_t)stack_size)
+        + THREADS_HOST_STACK_RESERVE;
+    if (!MapStack(pContext))
+    {
+        free(pContext);
+        return NULL;
+    }
+    return pContext;
+}
+
+/* Pools the context and its stack if its class is pooled and the pool
+   has room, otherwise frees them.  A pooled stack gives back every page
+   below its top one, so the next owner does not inherit the last owner's
+   RSS.  A painted stack keeps its pages: painting commits the whole stack
+   anyway, and PaintStack() only repaints what the last owner used. */
+static void FreeContext(threads_context_t* pContext)
+{
+    size_t released;
+
+    if (pContext->size_class != 0 && stackPoolBytes + pContext->stack_size <= THREADS_STACK_POOL_BYTES)
+    {
+        released = (pContext->stack_size - 1) & ~(pageSize - 1);
+        if (!pContext->painted && released != 0)
+        {
+            madvise(pContext->stack, released, MADV_DONTNEED);
+        }
+        pContext->pNextFree = stackPool[pContext->size_class - 1];
+        stackPool[pContext->size_class - 1] = pContext;
+        stackPoolBytes += pContext->stack_size;
+        return;
+    }
+
+    UnmapStack(pContext);
+    free(pContext);
+}
+
+/* Paints a new stack.  A painted stack coming back from the pool only
+   needs the part its last owner used painted again. */
+static void PaintStack(threads_context_t* pContext)
+{
+    size_t used = pContext->painted ? context_stack_high_water(pContext) : pContext->stack_size;
+
+    memset((char*)pContext->stack + pContext->stack_size - used, THREADS_STACK_PAINT, used);
+    pContext->painted = true;
+}
+
+/* Maps the context's stack, stack_size bytes rounded up to whole pages,
+   with a guard page below it while fewer than THREADS_GUARDED_STACKS
+   stacks have one, or if protecting the page fails.  Sets stack to the
+   lowest usable byte. */
+static bool MapStack(threads_context_t* pContext)
+{
+    size_t stack_size;
+    size_t guard_size;
+    char* pMapping;
+
+    if (pageSize == 0)
+    {
+        pageSize = (size_t)sysconf(_SC_PAGESIZE);
+    }
+    stack_size = (pContext->stack_size + pageSize - 1) & ~(pageSize - 1);
+    guard_size = guardedStacks < THREADS_GUARDED_STACKS ? pageSize : 0;
+
+    pMapping = mmap(NULL, stack_size + guard_size, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (pMapping == MAP_FAILED)
+    {
+        return false;
+    }
+    pContext->guarded = guard_size != 0 && mprotect(pMapping, guard_size, PROT_NONE) == 0;
+    if (pContext->guarded)
+    {
+        guardedStacks++;
+    }
+    else if (guard_size != 0)
+    {
+        munmap(pMapping, guard_size);
+    }
+    pContext->stack = pMapping + guard_size;
+    return true;
+}
+
+static void UnmapStack(threads_context_t* pContext)
+{
+    size_t stack_size = (pContext->stack_size + pageSize - 1) & ~(pageSize - 1);
+
+    if (pContext->guarded)
+    {
+        guardedStacks--;
+        munmap((char*)pContext->stack - pageSize, stack_size + pageSize);
+    }
+    else
+    {
+        munmap(pContext->stack, stack_size);
+    }
+}
+
+/**************************************************************************
+   PSR, clock and vectors
+*************************************************************************/
+uint32_t get_psr()
+{
+    return (uint32_t)psr;
+}
+
+void set_psr(uint32_t newPsr)
+{
+    psr = (sig_atomic_t)newPsr;
+
+    /* Deliver a tick that arrived while interrupts were disabled. */
+    if ((newPsr & PSR_INTERRUPTS) && timerPending)
+    {
+        DeliverTimerInterrupt();
+    }
+}
+
+uint32_t system_clock()
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)((now.tv_sec - clockStart.tv_sec) * 1000000LL +
+        (now.tv_nsec - clockStart.tv_nsec) / 1000);
+}
+
+interrupt_handler_t* get_interrupt_handlers()
+{
+    return interruptVector;
+}
+
+system_call_handler_t* get_system_call_vector()
+{
+    return systemCallVector;
+}
+
+/**************************************************************************
+   Name - DeliverTimerInterrupt
+
+   Purpose - Runs the THREADS_TIMER_INTERRUPT handler in kernel/IRQ mode
+             with interrupts disabled.  The handler may switch contexts;
+             the PSR is restored whenever this frame is resumed.
+*************************************************************************/
+static void DeliverTimerInterrupt(void)
+{
+    char deviceId[THREADS_MAX_DEVICE_NAME] = "clock";
+    interrupt_handler_t handler = interruptVector[THREADS_TIMER_INTERRUPT];
+    uint32_t savedPsr = (uint32_t)psr;
+
+    timerPending = 0;
+    if (handler == NULL)
+    {
+        return;
+    }
+
+    psr = (savedPsr | PSR_KERNEL_MODE | PSR_IRQ_MODE) & ~PSR_INTERRUPTS;
+    handler(deviceId, 0, system_clock());
+    psr = savedPsr;
+}
+
+/* Disables interrupts around a libc call and returns the PSR to restore.
+   A tick in the meantime is latched in timerPending. */
+static uint32_t MaskInterrupts(void)
+{
+    uint32_t savedPsr = (uint32_t)psr;
+
+    psr = (sig_atomic_t)(savedPsr & ~PSR_INTERRUPTS);
+    return savedPsr;
+}
+
+/* Restores the PSR saved by MaskInterrupts(), delivering a latched tick
+   if that enables interrupts again. */
+static void RestoreInterrupts(uint32_t savedPsr)
+{
+    set_psr(savedPsr);
+}
+
+static void TimerSignal(int signalNumber)
+{
+    (void)signalNumber;
+
+    if (psr & PSR_INTERRUPTS)
+    {
+        DeliverTimerInterrupt();
+    }
+    else
+    {
+        timerPending = 1;
+    }
+}
+
+/**************************************************************************
+   Devices
+*************************************************************************/
+static threads_device_t* FindDevice(char* device)
+{
+    for (int i = 0; device != NULL && i < deviceCount; ++i)
+    {
+        if (strcmp(deviceTable[i].name, device) == 0)
+        {
+            return &deviceTable[i];
+        }
+    }
+    return NULL;
+}
+
+uint32_t device_initialize(char* device)
+{
+    threads_device_t* pDevice = FindDevice(device);
+    uint32_t savedPsr;
+
+    if (pDevice == NULL)
+    {
+        return (uint32_t)-1;
+    }
+    if (pDevice->type == DEVICE_DISK && pDevice->sectors == NULL)
+    {
+        savedPsr = MaskInterrupts();
+        pDevice->sectors = calloc((size_t)THREADS_DISK_TRACKS * THREADS_DISK_SECTOR_COUNT,
+            THREADS_DISK_SECTOR_SIZE);
+        RestoreInterrupts(savedPsr);
+    }
+    pDevice->track = 0;
+    return 0;
+}
+
+uint32_t device_handle(char* device)
+{
+    threads_device_t* pDevice = FindDevice(device);
+
+    return pDevice == NULL ? (uint32_t)-1 : (uint32_t)(pDevice - deviceTable);
+}
+
+/**************************************************************************
+   Name - device_control
+
+   Purpose - Executes a device command synchronously.  control1 selects
+             the sector for disk reads and writes, and the track for seeks.
+
+   Returns - 0 on success, non-zero on an unknown device or command
+*************************************************************************/
+uint32_t device_control(char* device, device_control_block_t control_block)
+{
+    threads_device_t* pDevice = FindDevice(device);
+    uint8_t* pSector;
+    uint32_t savedPsr;
+    int c;
+
+    if (pDevice == NULL)
+    {
+        return (uint32_t)-1;
+    }
+
+    switch (pDevice->type)
+    {
+    case DEVICE_DISK:
+        if (pDevice->sectors == NULL)
+        {
+            device_initialize(device);
+        }
+        pSector = pDevice->sectors +
+            ((size_t)pDevice->track * THREADS_DISK_SECTOR_COUNT +
+             control_block.control1 % THREADS_DISK_SECTOR_COUNT) * THREADS_DISK_SECTOR_SIZE;
+
+        switch (control_block.command)
+        {
+        case DISK_INFO:
+            if (control_block.output_data != NULL)
+            {
+                *(uint32_t*)control_block.output_data = THREADS_DISK_TRACKS;
+            }
+            return 0;
+        case DISK_SEEK:
+            if (control_block.control1 >= THREADS_DISK_TRACKS)
+            {
+                return 1;
+            }
+            pDevice->track = control_block.control1;
+            return 0;
+        case DISK_READ:
+            memcpy(control_block.output_data, pSector, THREADS_DISK_SECTOR_SIZE);
+            return 0;
+        case DISK_WRITE:
+            memcpy(pSector, control_block.input_data, THREADS_DISK_SECTOR_SIZE);
+            return 0;
+        }
+        break;
+
+    case DEVICE_TERMINAL:
+        switch (control_block.command)
+        {
+        case TERMINAL_WRITE_CHAR:
+            savedPsr = MaskInterrupts();
+            fputc(control_block.control1, stdout);
+            fflush(stdout);
+            RestoreInterrupts(savedPsr);
+            return 0;
+        case TERMINAL_READ_CHAR:
+            if (control_block.output_data != NULL)
+            {
+                savedPsr = MaskInterrupts();
+                c = fgetc(stdin);
+                RestoreInterrupts(savedPsr);
+                *(char*)control_block.output_data = (char)(c == EOF ? 0 : c);
+                return c == EOF;
+            }
+            return 1;
+        }
+        break;
+
+    case DEVICE_CLOCK:
+        if (control_block.command == CLOCK_SET_TIMER)
+        {
+            return SetClockTimer(control_block.control1,
+                control_block.input_data != NULL ? *(uint32_t*)control_block.input_data : 0);
+        }
+        break;
+    }
+    return 1;
+}
+
+/**************************************************************************
+   Name - SetClockTimer
+
+   Purpose - Programs the clock interrupt.  CLOCK_PERIODIC ticks every
+             microseconds (THREADS_CLOCK_TICK_US if 0); CLOCK_ONE_SHOT
+             raises a single interrupt after microseconds, or none if 0.
+
+   Returns - 0 on success, non-zero for an unknown mode
+*************************************************************************/
+static uint32_t SetClockTimer(int mode, uint32_t microseconds)
+{
+    struct itimerval timer = { 0 };
+
+    if (mode == CLOCK_PERIODIC && microseconds == 0)
+    {
+        microseconds = THREADS_CLOCK_TICK_US;
+    }
+    else if (mode != CLOCK_PERIODIC && mode != CLOCK_ONE_SHOT)
+    {
+        return 1;
+    }
+
+    timer.it_value.tv_sec = microseconds / 1000000;
+    timer.it_value.tv_usec = microseconds % 1000000;
+    if (mode == CLOCK_PERIODIC)
+    {
+        timer.it_interval = timer.it_value;
+    }
+    setitimer(ITIMER_REAL, &timer, NULL);
+    return 0;
+}
+
+static void AddDevice(const char* name, device_type_t type, int unit)
+{
+    threads_device_t* pDevice = &deviceTable[deviceCount++];
+
+    snprintf(pDevice->name, sizeof(pDevice->name), "%s", name);
+    pDevice->type = type;
+    pDevice->unit = unit;
+}
+
+/**************************************************************************
+   Console and shutdown
+*************************************************************************/
+void set_debug_level(int level)
+{
+    debugLevel = level;
+}
+
+void console_output(bool debug, char* string, ...)
+{
+    va_list argptr;
+    uint32_t savedPsr;
+
+    (void)debug;    /* callers already gate debug output */
+
+    savedPsr = MaskInterrupts();
+    va_start(argptr, string);
+    vfprintf(stdout, string, argptr);
+    va_end(argptr);
+    fflush(stdout);
+    RestoreInterrupts(savedPsr);
+}
+
+void stop(int code)
+{
+    struct itimerval disarm = { 0 };
+
+    MaskInterrupts();
+    setitimer(ITIMER_REAL, &disarm, NULL);
+    fflush(stdout);
+    exit(code);
+}
+
+/**************************************************************************
+   Name - threads_initialize
+
+   Purpose - Host setup done by THREADSMain before bootstrap(): clock
+             origin, device table and the periodic timer interrupt.  The
+             kernel can reprogram the timer through the clock device.
+*************************************************************************/
+void threads_initialize(void)
+{
+    struct sigaction action;
+    char name[THREADS_MAX_DEVICE_NAME];
+
+    clock_gettime(CLOCK_MONOTONIC, &clockStart);
+
+    AddDevice("clock", DEVICE_CLOCK, THREADS_CLOCK_DEVICE_ID);
+    for (int i = 0; i < THREADS_MAX_DISKS && deviceCount < THREADS_MAX_DEVICES; ++i)
+    {
+        snprintf(name, sizeof(name), "disk%d", i);
+        AddDevice(name, DEVICE_DISK, i);
+    }
+    for (int i = 0; i < THREADS_MAX_TERMINALS && deviceCount < THREADS_MAX_DEVICES; ++i)
+    {
+        snprintf(name, sizeof(name), "term%d", i);
+        AddDevice(name, DEVICE_TERMINAL, i);
+    }
+
+    /* SA_NODEFER: the handler may switch to another context and never
+       return to sigreturn for a while, so SIGALRM must not stay blocked.
+       Nesting is prevented by the PSR instead. */
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = TimerSignal;
+    action.sa_flags = SA_RESTART | SA_NODEFER;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGALRM, &action, NULL);
+
+    SetClockTimer(CLOCK_PERIODIC, THREADS_CLOCK_TICK_US);
+}
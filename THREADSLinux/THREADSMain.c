@@ -0,0 +1,31 @@
+/*
+ * THREADSMain.c
+ *
+ * Linux counterpart of Lib/THREADSMain.lib: the program entry point that
+ * prepares the runtime and hands control to the scheduler's bootstrap().
+ */
+#include <stdio.h>
+#include "THREADSLib.h"
+
+extern void threads_initialize(void);
+
+int main(int argc, char* argv[])
+{
+    char* debugLevel = getenv("THREADS_DEBUG");
+
+    (void)argc;
+    (void)argv;
+
+    if (debugLevel != NULL)
+    {
+        set_debug_level(atoi(debugLevel));
+    }
+
+    threads_initialize();
+
+    /* bootstrap() switches to the first process and never returns. */
+    bootstrap(NULL);
+
+    stop(-3);
+    return 0;
+}
@@ -0,0 +1,222 @@
+#include <stdlib.h>
+#include "THREADSLib.h"
+#include "ZombieTable.h"
+#include "IndexList.h"
+
+/* Records come from chunks of ZOMBIE_CHUNK_SIZE that never move, so a
+   record number stays valid while the record is in use.  Free records are
+   chained through nextZombie.  The pid hash grows with the record count. */
+#define ZOMBIE_CHUNK_SIZE       1024
+#define ZOMBIE_MIN_BUCKETS      64
+
+/* Six 4-byte fields.  Record numbers are not bounded by MAXPROC (a parent
+   may leave any number of children unreaped), so the links stay 32 bits. */
+_Static_assert(sizeof(Zombie) == 24, "Zombie records are 24 bytes");
+
+static Zombie** zombieChunks;
+static unsigned int chunkCount;
+static unsigned int freeZombies;            /* free list head */
+static unsigned int* buckets;
+static unsigned int bucketCount;
+static int zombieCount;
+
+INDEX_DLIST(ZombieList, Zombie, unsigned int, ZombieFromNumber, nextZombie, prevZombie)
+
+static int AddChunk(void);
+static void GrowBuckets(void);
+static inline unsigned int HashPid(int pid);
+
+/* ---------------------------------------------------------------
+    ZombieCreate
+
+    Purpose - Records the exit of a process
+    Parameters - its pid, its parent's pid and its exit code
+    Returns - the record number, or 0 if out of memory
+--------------------------------------------------------------- */
+unsigned int ZombieCreate(int pid, int parentPid, int exitCode)
+{
+    unsigned int zombie;
+    Zombie* pZombie;
+
+    if (freeZombies == 0 && !AddChunk())
+    {
+        return 0;
+    }
+    if (zombieCount >= (int)bucketCount)
+    {
+        GrowBuckets();
+    }
+
+    zombie = freeZombies;
+    pZombie = ZombieFromNumber(zombie);
+    freeZombies = pZombie->nextZombie;
+
+    pZombie->pid = pid;
+    pZombie->parentPid = parentPid;
+    pZombie->exitCode = exitCode;
+    pZombie->nextZombie = pZombie->prevZombie = 0;
+    pZombie->nextHash = buckets[HashPid(pid)];
+    buckets[HashPid(pid)] = zombie;
+    zombieCount++;
+
+    return zombie;
+}
+
+/* ---------------------------------------------------------------
+    ZombieRelease
+
+    Purpose - Frees a record once its process has been reaped.  The
+                caller takes it off the parent's queue first.
+    Parameters - the record number
+--------------------------------------------------------------- */
+void ZombieRelease(unsigned int zombie)
+{
+    Zombie* pZombie = ZombieFromNumber(zombie);
+    unsigned int* pLink = &buckets[HashPid(pZombie->pid)];
+
+    while (*pLink != zombie)
+    {
+        pLink = &ZombieFromNumber(*pLink)->nextHash;
+    }
+    *pLink = pZombie->nextHash;
+
+    pZombie->pid = 0;
+    pZombie->nextZombie = freeZombies;
+    freeZombies = zombie;
+    zombieCount--;
+}
+
+/* ---------------------------------------------------------------
+    ZombieFind
+
+    Returns - the record number of an exited, unreaped process, or 0
+--------------------------------------------------------------- */
+unsigned int ZombieFind(int pid)
+{
+    unsigned int zombie;
+
+    if (bucketCount == 0)
+    {
+        return 0;
+    }
+    for (zombie = buckets[HashPid(pid)]; zombie != 0; zombie = ZombieFromNumber(zombie)->nextHash)
+    {
+        if (ZombieFromNumber(zombie)->pid == pid)
+        {
+            return zombie;
+        }
+    }
+    return 0;
+}
+
+/* ---------------------------------------------------------------
+    ZombieFromNumber
+
+    Returns - the record with the given number, NULL for 0
+--------------------------------------------------------------- */
+Zombie* ZombieFromNumber(unsigned int zombie)
+{
+    return zombie == 0 ? NULL :
+        &zombieChunks[(zombie - 1) / ZOMBIE_CHUNK_SIZE][(zombie - 1) % ZOMBIE_CHUNK_SIZE];
+}
+
+/* ---------------------------------------------------------------
+    ZombieCount
+
+    Returns - the number of exited processes not yet reaped
+--------------------------------------------------------------- */
+int ZombieCount(void)
+{
+    return zombieCount;
+}
+
+/* ---------------------------------------------------------------
+    ZombieQueuePush / ZombieQueuePop / ZombieQueueRemove
+
+    Purpose - Add a record at the end of a parent's queue, take the
+                oldest record off it (0 if it is empty), and take a
+                record off the queue it is on
+    Parameters - the queue (the parent's oldest record), the record
+--------------------------------------------------------------- */
+void ZombieQueuePush(unsigned int* pQueue, unsigned int zombie)
+{
+    ZombieListAppend(pQueue, zombie);
+}
+
+unsigned int ZombieQueuePop(unsigned int* pQueue)
+{
+    return ZombieListPop(pQueue);
+}
+
+void ZombieQueueRemove(unsigned int* pQueue, unsigned int zombie)
+{
+    ZombieListRemove(pQueue, zombie);
+}
+
+/* Adds a chunk of records to the free list. */
+static int AddChunk(void)
+{
+    Zombie** newChunks = realloc(zombieChunks, (chunkCount + 1) * sizeof(Zombie*));
+    Zombie* pChunk;
+
+    if (newChunks == NULL)
+    {
+        return FALSE;
+    }
+    zombieChunks = newChunks;
+
+    pChunk = calloc(ZOMBIE_CHUNK_SIZE, sizeof(Zombie));
+    if (pChunk == NULL)
+    {
+        return FALSE;
+    }
+    zombieChunks[chunkCount] = pChunk;
+
+    for (int i = ZOMBIE_CHUNK_SIZE - 1; i >= 0; --i)
+    {
+        pChunk[i].nextZombie = freeZombies;
+        freeZombies = chunkCount * ZOMBIE_CHUNK_SIZE + i + 1;
+    }
+    chunkCount++;
+    return TRUE;
+}
+
+/* Doubles the pid hash.  Failing leaves the old one, which still works
+   with longer chains; only the first table is required. */
+static void GrowBuckets(void)
+{
+    unsigned int newCount = bucketCount == 0 ? ZOMBIE_MIN_BUCKETS : bucketCount * 2;
+    unsigned int* newBuckets = calloc(newCount, sizeof(unsigned int));
+    unsigned int* oldBuckets = buckets;
+    unsigned int oldCount = bucketCount;
+    unsigned int zombie, next;
+
+    if (newBuckets == NULL)
+    {
+        if (bucketCount == 0)
+        {
+            console_output(FALSE, "ZombieCreate(): out of memory for the pid hash, stopping...\n");
+            stop(1);
+        }
+        return;
+    }
+
+    buckets = newBuckets;
+    bucketCount = newCount;
+    for (unsigned int i = 0; i < oldCount; ++i)
+    {
+        for (zombie = oldBuckets[i]; zombie != 0; zombie = next)
+        {
+            next = ZombieFromNumber(zombie)->nextHash;
+            ZombieFromNumber(zombie)->nextHash = buckets[HashPid(ZombieFromNumber(zombie)->pid)];
+            buckets[HashPid(ZombieFromNumber(zombie)->pid)] = zombie;
+        }
+    }
+    free(oldBuckets);
+}
+
+/* Pids differ mostly in the slot bits, then the generation. */
+static inline unsigned int HashPid(int pid)
+{
+    return ((unsigned int)pid * 2654435761u) >> 7 & (bucketCount - 1);
+}
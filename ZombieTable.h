@@ -0,0 +1,30 @@
+#pragma once
+
+/* Exit records.  A process that exits while its parent is alive is removed
+   from the process table at once and leaves only this record, queued on
+   its parent, until the parent reaps it with k_wait or k_waitpid.  Records
+   are referred to by number (record index + 1, 0 for none) and can also be
+   found by pid, for k_join and k_waitpid.  A record is 24 bytes.
+
+   A parent's queue is an INDEX_DLIST (IndexList.h) in exit order, held
+   by its oldest record, so pushing, popping the oldest and removing any
+   record are all O(1). */
+typedef struct _zombie
+{
+	int            pid;
+	int            parentPid;
+	int            exitCode;
+	unsigned int   nextZombie;        /* the parent's queue */
+	unsigned int   prevZombie;
+	unsigned int   nextHash;          /* pid hash chain */
+} Zombie;
+
+unsigned int ZombieCreate(int pid, int parentPid, int exitCode);
+void         ZombieRelease(unsigned int zombie);
+unsigned int ZombieFind(int pid);
+Zombie*      ZombieFromNumber(unsigned int zombie);
+int          ZombieCount(void);
+
+void         ZombieQueuePush(unsigned int* pQueue, unsigned int zombie);
+unsigned int ZombieQueuePop(unsigned int* pQueue);
+void         ZombieQueueRemove(unsigned int* pQueue, unsigned int zombie);
@@ -0,0 +1,47 @@
+#!/bin/sh
+#
+# Linux counterpart of RunSchedulerTests.bat.  Runs each SchedulerTest
+# program built by the Makefile and reports the ones that crash or do not
+# finish.  A test that halts through stop() with a non-zero code (e.g. the
+# kernel mode and priority checks) still counts as finished.
+#
+#   BIN_DIR=build/bin sh bin/RunSchedulerTests.sh [SchedulerTestNN ...]
+#
+# The kernel reads SCHEDULER_POLICY and SCHEDULER_TICKLESS, so e.g.
+# SCHEDULER_POLICY=cfs runs the suite under another scheduling policy.
+
+BIN_DIR=${BIN_DIR:-build/bin}
+TEST_TIMEOUT=${TEST_TIMEOUT:-120}
+
+# Known failures in the current kernel, reported as XFAIL (none at present):
+EXPECTED_FAILURES=""
+
+if [ $# -eq 0 ]; then
+    set -- $(cd "$BIN_DIR" && ls -d SchedulerTest[0-9]*)
+fi
+
+failed=0
+for test in "$@"; do
+    timeout "$TEST_TIMEOUT" "$BIN_DIR/$test" > "$BIN_DIR/$test.out" 2>&1
+    code=$?
+    case " $EXPECTED_FAILURES " in
+        *" $test "*) expected=1 ;;
+        *) expected=0 ;;
+    esac
+    if [ $code -eq 124 ] || [ $code -ge 128 ]; then
+        if [ $expected -eq 1 ]; then
+            echo "XFAIL $test (exit $code)"
+        else
+            echo "FAIL  $test (exit $code, output in $BIN_DIR/$test.out)"
+            failed=$((failed + 1))
+        fi
+    else
+        if [ $expected -eq 1 ]; then
+            echo "XPASS $test (exit $code)"
+        else
+            echo "ok    $test (exit $code)"
+        fi
+    fi
+done
+
+[ $failed -eq 0 ]